@@ -0,0 +1,212 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BoxBenchmarkSubsystem.h"
+#include "MyBox.h"
+#include "MultiplayerReplicationGraph.h"
+#include "SoakReport.h"
+#include "EngineUtils.h"
+#include "Engine/NetDriver.h"
+#include "GameFramework/PlayerStart.h"
+#include "HAL/IConsoleManager.h"
+
+// Seconds after spawning before sampling, while every client opens a channel for every box
+static constexpr double BoxBenchmarkWarmupSeconds = 3.0;
+
+static FAutoConsoleCommandWithWorldAndArgs BoxBenchmarkCommand(
+	TEXT("MultiplayerCourse.MyBox.Benchmark"),
+	TEXT("Spawns boxes with push model and dormancy, then without, and logs outgoing bytes/s and ServerReplicateActors ms for each.\n")
+	TEXT("Takes the box count and the seconds sampled per mode, defaults to 500 10. Run on a host with clients connected."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		UBoxBenchmarkSubsystem* Benchmark = World ? World->GetSubsystem<UBoxBenchmarkSubsystem>() : nullptr;
+		if (!Benchmark)
+		{
+			return;
+		}
+
+		const int32 NumBoxes = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 500;
+		const float SampleSeconds = Args.Num() > 1 ? FMath::Max(FCString::Atof(*Args[1]), 1.0f) : 10.0f;
+		Benchmark->Start(NumBoxes, SampleSeconds);
+	}));
+
+bool UBoxBenchmarkSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UBoxBenchmarkSubsystem::Deinitialize()
+{
+	if (bRunning)
+	{
+		Finish();
+	}
+
+	Super::Deinitialize();
+}
+
+bool UBoxBenchmarkSubsystem::IsTickable() const
+{
+	return bRunning;
+}
+
+TStatId UBoxBenchmarkSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBoxBenchmarkSubsystem, STATGROUP_Tickables);
+}
+
+void UBoxBenchmarkSubsystem::Start(int32 InNumBoxes, float InSampleSeconds)
+{
+	if (bRunning)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Box benchmark is already running"));
+		return;
+	}
+
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	if (!NetDriver || NetDriver->ClientConnections.Num() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Box benchmark needs a host with clients connected, nothing is replicated otherwise"));
+		return;
+	}
+
+	PushModelVariable = IConsoleManager::Get().FindConsoleVariable(TEXT("net.IsPushModelEnabled"));
+	PreviousPushModelValue = PushModelVariable ? PushModelVariable->GetInt() : 0;
+
+	NumBoxes = InNumBoxes;
+	SampleSeconds = InSampleSeconds;
+	bOptimized = true;
+	bRunning = true;
+	BeginMode();
+}
+
+void UBoxBenchmarkSubsystem::BeginMode()
+{
+	// Push model is read per replication pass, dormancy when each box begins play
+	if (PushModelVariable)
+	{
+		PushModelVariable->Set(bOptimized ? 1 : 0, ECVF_SetByConsole);
+	}
+
+	SpawnBoxes();
+
+	ModeStartTime = FPlatformTime::Seconds();
+	LastSampleTime = ModeStartTime + BoxBenchmarkWarmupSeconds;
+	OutBytesPerSecond.Reset();
+	ReplicateActorsMs.Reset();
+
+	// Drop whatever the graph timed before the boxes existed
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	if (UMultiplayerReplicationGraph* Graph = NetDriver ? Cast<UMultiplayerReplicationGraph>(NetDriver->GetReplicationDriver()) : nullptr)
+	{
+		Graph->ConsumeAverageReplicateActorsMs();
+	}
+}
+
+void UBoxBenchmarkSubsystem::Tick(float DeltaTime)
+{
+	const double Now = FPlatformTime::Seconds();
+	if (Now - LastSampleTime < 1.0)
+	{
+		return;
+	}
+
+	LastSampleTime = Now;
+
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	if (!NetDriver)
+	{
+		Finish();
+		return;
+	}
+
+	OutBytesPerSecond.Add(NetDriver->OutBytesPerSecond);
+	if (UMultiplayerReplicationGraph* Graph = Cast<UMultiplayerReplicationGraph>(NetDriver->GetReplicationDriver()))
+	{
+		ReplicateActorsMs.Add(Graph->ConsumeAverageReplicateActorsMs());
+	}
+
+	if (Now - ModeStartTime < BoxBenchmarkWarmupSeconds + SampleSeconds)
+	{
+		return;
+	}
+
+	// Without the graph there's no replication timer, compare frame times with 'stat net' instead
+	UE_LOG(LogTemp, Log, TEXT("Box benchmark, %d boxes, %d connections, %s: %.0f bytes/s out, ServerReplicateActors %s ms"),
+		Boxes.Num(), NetDriver->ClientConnections.Num(),
+		bOptimized ? TEXT("push model and dormancy") : TEXT("no push model, always awake"),
+		SoakReport::Average(OutBytesPerSecond),
+		ReplicateActorsMs.Num() > 0 ? *FString::Printf(TEXT("%.3f"), SoakReport::Average(ReplicateActorsMs)) : TEXT("n/a"));
+
+	DestroyBoxes();
+
+	if (bOptimized)
+	{
+		bOptimized = false;
+		BeginMode();
+		return;
+	}
+
+	Finish();
+}
+
+void UBoxBenchmarkSubsystem::SpawnBoxes()
+{
+	UWorld* World = GetWorld();
+
+	FVector Origin = FVector::ZeroVector;
+	TActorIterator<APlayerStart> PlayerStart(World);
+	if (PlayerStart)
+	{
+		Origin = PlayerStart->GetActorLocation();
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParameters.ObjectFlags |= RF_Transient;
+	SpawnParameters.bDeferConstruction = true;
+
+	// Close enough together that every box stays relevant to players near the start
+	const int32 Columns = FMath::CeilToInt(FMath::Sqrt((float)NumBoxes));
+	for (int32 Index = 0; Index < NumBoxes; ++Index)
+	{
+		const FTransform Transform(Origin + FVector((Index % Columns - Columns / 2) * 150.0f, (Index / Columns - Columns / 2) * 150.0f, 0.0f));
+		AMyBox* Box = World->SpawnActor<AMyBox>(AMyBox::StaticClass(), Transform, SpawnParameters);
+		if (!Box)
+		{
+			continue;
+		}
+
+		Box->bUseNetDormancy = bOptimized;
+		Box->FinishSpawning(Transform);
+		Boxes.Add(Box);
+
+		if (Index % 10 == 0)
+		{
+			Box->DecreaseReplicatedVar();
+		}
+	}
+}
+
+void UBoxBenchmarkSubsystem::DestroyBoxes()
+{
+	for (AMyBox* Box : Boxes)
+	{
+		if (Box)
+		{
+			Box->Destroy();
+		}
+	}
+	Boxes.Reset();
+}
+
+void UBoxBenchmarkSubsystem::Finish()
+{
+	DestroyBoxes();
+	if (PushModelVariable)
+	{
+		PushModelVariable->Set(PreviousPushModelValue, ECVF_SetByConsole);
+	}
+	bRunning = false;
+}
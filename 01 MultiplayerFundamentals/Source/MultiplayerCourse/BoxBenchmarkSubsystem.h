@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "BoxBenchmarkSubsystem.generated.h"
+
+class AMyBox;
+class IConsoleVariable;
+
+/**
+ * Compares what AMyBox costs the server's replication with push model and dormancy against without
+ * them. For each mode it spawns N boxes, starts the ReplicatedVar countdown on every tenth one so some
+ * state keeps changing, and samples the net driver's outgoing bytes and ServerReplicateActors time
+ * once a second. Started with MultiplayerCourse.MyBox.Benchmark on a host with clients connected.
+ */
+UCLASS()
+class MULTIPLAYERCOURSE_API UBoxBenchmarkSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	void Start(int32 InNumBoxes, float InSampleSeconds);
+
+private:
+	void BeginMode();
+	void SpawnBoxes();
+	void DestroyBoxes();
+	void Finish();
+
+	UPROPERTY()
+	TArray<TObjectPtr<AMyBox>> Boxes;
+
+	IConsoleVariable* PushModelVariable = nullptr;
+	int32 PreviousPushModelValue = 1;
+
+	bool bRunning = false;
+	bool bOptimized = true;
+	int32 NumBoxes = 0;
+	float SampleSeconds = 0.0f;
+
+	double ModeStartTime = 0.0;
+	double LastSampleTime = 0.0;
+	TArray<uint32> OutBytesPerSecond;
+	TArray<float> ReplicateActorsMs;
+};
@@ -0,0 +1,26 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CosmeticEventComponent.h"
+#include "EffectPlaybackSubsystem.h"
+
+UCosmeticEventComponent::UCosmeticEventComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	SetIsReplicatedByDefault(true);
+}
+
+void UCosmeticEventComponent::ClientReceiveCosmeticEvents_Implementation(const TArray<FCosmeticEvent>& Events)
+{
+	UEffectPlaybackSubsystem* EffectPlayback = GetWorld()->GetSubsystem<UEffectPlaybackSubsystem>();
+	if (!EffectPlayback)
+	{
+		return;
+	}
+
+	for (const FCosmeticEvent& Event : Events)
+	{
+		EffectPlayback->PlayEffect(Event.Template, Event.Location);
+	}
+}
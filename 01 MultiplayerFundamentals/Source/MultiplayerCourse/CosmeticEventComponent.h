@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Engine/NetSerialization.h"
+#include "CosmeticEventComponent.generated.h"
+
+class UParticleSystem;
+
+// One effect for a client to play, see UCosmeticEventSubsystem
+USTRUCT()
+struct FCosmeticEvent
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<UParticleSystem> Template;
+
+	UPROPERTY()
+	FVector_NetQuantize Location;
+};
+
+/**
+ * Delivers a player's bundle of cosmetic events from UCosmeticEventSubsystem.
+ * Lives on the player's pawn so the unreliable RPC goes to the owning connection,
+ * and hands the events to UEffectPlaybackSubsystem on arrival.
+ */
+UCLASS(ClassGroup = (Network), meta = (BlueprintSpawnableComponent))
+class MULTIPLAYERCOURSE_API UCosmeticEventComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UCosmeticEventComponent();
+
+	// Lost bundles are not resent, cosmetic events are never worth a reliable slot
+	UFUNCTION(Client, Unreliable)
+	void ClientReceiveCosmeticEvents(const TArray<FCosmeticEvent>& Events);
+};
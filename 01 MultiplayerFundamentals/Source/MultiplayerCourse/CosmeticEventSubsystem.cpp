@@ -0,0 +1,211 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CosmeticEventSubsystem.h"
+#include "MultiplayerCourse.h"
+#include "EffectPlaybackSubsystem.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Cosmetic Event Flush"), STAT_CosmeticEventFlush, STATGROUP_MultiplayerCourse);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Cosmetic Events Sent"), STAT_CosmeticEventsSent, STATGROUP_MultiplayerCourse);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Cosmetic Bundles Sent"), STAT_CosmeticBundlesSent, STATGROUP_MultiplayerCourse);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Cosmetic Events Dropped"), STAT_CosmeticEventsDropped, STATGROUP_MultiplayerCourse);
+
+static TAutoConsoleVariable<float> CVarCosmeticEventMaxAge(
+	TEXT("MultiplayerCourse.CosmeticEvents.MaxAge"),
+	0.25f,
+	TEXT("Seconds a queued cosmetic event may wait for its connection before it is dropped."));
+
+static TAutoConsoleVariable<int32> CVarCosmeticEventMaxPerBundle(
+	TEXT("MultiplayerCourse.CosmeticEvents.MaxPerBundle"),
+	16,
+	TEXT("Most events sent to one player per frame, the oldest are dropped beyond this."));
+
+bool UCosmeticEventSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UCosmeticEventSubsystem::Deinitialize()
+{
+	if (UNetDriver* NetDriver = BoundNetDriver.Get())
+	{
+		NetDriver->OnTickFlush().Remove(TickFlushHandle);
+	}
+	BoundNetDriver.Reset();
+
+	Super::Deinitialize();
+}
+
+void UCosmeticEventSubsystem::QueueForOwner(const AActor* Target, UParticleSystem* Template, const FVector& Location)
+{
+	if (!Target || !Template)
+	{
+		return;
+	}
+
+	const AActor* NetOwner = Target->GetNetOwner();
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (It->Get() && It->Get() == NetOwner)
+		{
+			Queue(It->Get(), Template, Location);
+			return;
+		}
+	}
+}
+
+void UCosmeticEventSubsystem::QueueForRelevant(AActor* Source, UParticleSystem* Template, const FVector& Location)
+{
+	if (!Source || !Template)
+	{
+		return;
+	}
+
+	bool bPlayedLocally = false;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PlayerController = It->Get();
+		if (!PlayerController)
+		{
+			continue;
+		}
+
+		// Splitscreen players share one world, the effect only has to play there once
+		if (PlayerController->IsLocalController())
+		{
+			if (!bPlayedLocally)
+			{
+				Queue(PlayerController, Template, Location);
+				bPlayedLocally = true;
+			}
+			continue;
+		}
+
+		// The channel stays open while the net driver or replication graph considers Source relevant
+		UNetConnection* Connection = PlayerController->GetNetConnection();
+		if (Connection && Connection->FindActorChannelRef(Source))
+		{
+			Queue(PlayerController, Template, Location);
+		}
+	}
+}
+
+void UCosmeticEventSubsystem::Queue(APlayerController* PlayerController, UParticleSystem* Template, const FVector& Location)
+{
+	if (PlayerController->IsLocalController())
+	{
+		if (UEffectPlaybackSubsystem* EffectPlayback = GetWorld()->GetSubsystem<UEffectPlaybackSubsystem>())
+		{
+			EffectPlayback->PlayEffect(Template, Location);
+		}
+		return;
+	}
+
+	// The net driver is created when the world starts listening, which can be after this subsystem
+	UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	if (!NetDriver)
+	{
+		return;
+	}
+
+	if (BoundNetDriver != NetDriver)
+	{
+		if (UNetDriver* OldNetDriver = BoundNetDriver.Get())
+		{
+			OldNetDriver->OnTickFlush().Remove(TickFlushHandle);
+		}
+		TickFlushHandle = NetDriver->OnTickFlush().AddUObject(this, &UCosmeticEventSubsystem::OnTickFlush);
+		BoundNetDriver = NetDriver;
+	}
+
+	FQueuedCosmeticEvent& Queued = Queues.FindOrAdd(PlayerController).AddDefaulted_GetRef();
+	Queued.Event.Template = Template;
+	Queued.Event.Location = Location;
+	Queued.QueueTime = GetWorld()->GetTimeSeconds();
+}
+
+void UCosmeticEventSubsystem::OnTickFlush(float DeltaSeconds)
+{
+	// Runs before the driver sends its packets, once per net tick so events from several
+	// server frames share a bundle when the server runs faster than it replicates
+	const UNetDriver* NetDriver = BoundNetDriver.Get();
+	const int32 NetTickRate = NetDriver ? NetDriver->GetNetServerMaxTickRate() : 0;
+	const float FlushInterval = NetTickRate > 0 ? 1.0f / NetTickRate : 0.0f;
+
+	TimeSinceFlush += DeltaSeconds;
+	if (Queues.Num() == 0 || TimeSinceFlush < FlushInterval)
+	{
+		return;
+	}
+
+	// Keep the remainder so frame time jitter doesn't halve the flush rate
+	TimeSinceFlush = FMath::Min(TimeSinceFlush - FlushInterval, FlushInterval);
+
+	SCOPE_CYCLE_COUNTER(STAT_CosmeticEventFlush);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	const double MaxAge = CVarCosmeticEventMaxAge.GetValueOnGameThread();
+
+	for (auto It = Queues.CreateIterator(); It; ++It)
+	{
+		APlayerController* PlayerController = It->Key.Get();
+		TArray<FQueuedCosmeticEvent>& Events = It->Value;
+
+		const int32 NumStale = Events.RemoveAll([Now, MaxAge](const FQueuedCosmeticEvent& Queued)
+		{
+			return Now - Queued.QueueTime > MaxAge;
+		});
+		NumEventsDropped += NumStale;
+		INC_DWORD_STAT_BY(STAT_CosmeticEventsDropped, NumStale);
+
+		if (!PlayerController || Events.Num() == 0 || Flush(PlayerController, Events))
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+bool UCosmeticEventSubsystem::Flush(APlayerController* PlayerController, TArray<FQueuedCosmeticEvent>& Events)
+{
+	// A saturated connection would only drop the bundle, hold on to it until it ages out
+	UNetConnection* Connection = PlayerController->GetNetConnection();
+	if (Connection && !Connection->IsNetReady(false))
+	{
+		return false;
+	}
+
+	APawn* Pawn = PlayerController->GetPawn();
+	UCosmeticEventComponent* Channel = Pawn ? Pawn->FindComponentByClass<UCosmeticEventComponent>() : nullptr;
+	if (!Connection || !Channel)
+	{
+		NumEventsDropped += Events.Num();
+		INC_DWORD_STAT_BY(STAT_CosmeticEventsDropped, Events.Num());
+		return true;
+	}
+
+	// Newest events win when there are more than fit in a bundle
+	const int32 NumToSend = FMath::Min(Events.Num(), FMath::Max(CVarCosmeticEventMaxPerBundle.GetValueOnGameThread(), 1));
+	const int32 NumSkipped = Events.Num() - NumToSend;
+	NumEventsDropped += NumSkipped;
+	INC_DWORD_STAT_BY(STAT_CosmeticEventsDropped, NumSkipped);
+
+	TArray<FCosmeticEvent> Bundle;
+	Bundle.Reserve(NumToSend);
+	for (int32 Index = NumSkipped; Index < Events.Num(); ++Index)
+	{
+		Bundle.Add(Events[Index].Event);
+	}
+	Channel->ClientReceiveCosmeticEvents(Bundle);
+
+	NumEventsSent += NumToSend;
+	++NumBundlesSent;
+	INC_DWORD_STAT_BY(STAT_CosmeticEventsSent, NumToSend);
+	INC_DWORD_STAT(STAT_CosmeticBundlesSent);
+	return true;
+}
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CosmeticEventComponent.h"
+#include "CosmeticEventSubsystem.generated.h"
+
+class APlayerController;
+class UNetDriver;
+
+/**
+ * Channel for cosmetic events that would otherwise each be a reliable RPC.
+ * Events are queued per player and sent from the net driver's TickFlush, at most once per
+ * net tick (NetServerMaxTickRate), as a single unreliable
+ * UCosmeticEventComponent::ClientReceiveCosmeticEvents bundle. Events older than
+ * MultiplayerCourse.CosmeticEvents.MaxAge, e.g. held back while a connection is saturated,
+ * are dropped instead of sent. Local players play their events directly.
+ */
+UCLASS()
+class MULTIPLAYERCOURSE_API UCosmeticEventSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	// Plays Template for the player that owns Target only, what a Client RPC on Target would do
+	void QueueForOwner(const AActor* Target, UParticleSystem* Template, const FVector& Location);
+
+	// Plays Template for every player Source is currently relevant to, i.e. whose connection has an
+	// actor channel open for it, what a Multicast RPC on Source would reach
+	void QueueForRelevant(AActor* Source, UParticleSystem* Template, const FVector& Location);
+
+	int32 GetNumEventsSent() const { return NumEventsSent; }
+	int32 GetNumBundlesSent() const { return NumBundlesSent; }
+	int32 GetNumEventsDropped() const { return NumEventsDropped; }
+
+private:
+	struct FQueuedCosmeticEvent
+	{
+		FCosmeticEvent Event;
+		double QueueTime;
+	};
+
+	void Queue(APlayerController* PlayerController, UParticleSystem* Template, const FVector& Location);
+
+	// Bound to the world's net driver the first time an event is queued for a remote player
+	void OnTickFlush(float DeltaSeconds);
+
+	// Returns false while events have to wait for the connection
+	bool Flush(APlayerController* PlayerController, TArray<FQueuedCosmeticEvent>& Events);
+
+	TMap<TWeakObjectPtr<APlayerController>, TArray<FQueuedCosmeticEvent>> Queues;
+
+	TWeakObjectPtr<UNetDriver> BoundNetDriver;
+	FDelegateHandle TickFlushHandle;
+	float TimeSinceFlush = 0.0f;
+
+	int32 NumEventsSent = 0;
+	int32 NumBundlesSent = 0;
+	int32 NumEventsDropped = 0;
+};
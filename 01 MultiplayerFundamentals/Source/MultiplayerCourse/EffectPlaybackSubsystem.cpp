@@ -0,0 +1,201 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "EffectPlaybackSubsystem.h"
+#include "MultiplayerCourse.h"
+#include "Particles/ParticleSystem.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/WorldSettings.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Effect Playback Tick"), STAT_EffectPlaybackTick, STATGROUP_MultiplayerCourse);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Effects Spawned"), STAT_EffectsSpawned, STATGROUP_MultiplayerCourse);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Effects Dropped"), STAT_EffectsDropped, STATGROUP_MultiplayerCourse);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Effects Deferred"), STAT_EffectsDeferred, STATGROUP_MultiplayerCourse);
+
+static TAutoConsoleVariable<int32> CVarEffectSpawnBudget(
+	TEXT("MultiplayerCourse.Effects.SpawnBudget"),
+	4,
+	TEXT("Maximum number of effects started per frame. The rest are deferred to later frames."));
+
+static TAutoConsoleVariable<float> CVarEffectMaxDeferSeconds(
+	TEXT("MultiplayerCourse.Effects.MaxDeferSeconds"),
+	0.25f,
+	TEXT("Deferred effects older than this are dropped."));
+
+static TAutoConsoleVariable<float> CVarEffectCullDistance(
+	TEXT("MultiplayerCourse.Effects.CullDistance"),
+	5000.0f,
+	TEXT("Effects farther than this from every local viewpoint are dropped. 0 disables culling."));
+
+static TAutoConsoleVariable<int32> CVarEffectMaxPoolSize(
+	TEXT("MultiplayerCourse.Effects.MaxPoolSize"),
+	32,
+	TEXT("Maximum number of components kept per particle system."));
+
+bool UEffectPlaybackSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UEffectPlaybackSubsystem::Deinitialize()
+{
+	for (UParticleSystemComponent* Component : AllComponents)
+	{
+		if (Component)
+		{
+			Component->DestroyComponent();
+		}
+	}
+	AllComponents.Empty();
+	Pools.Empty();
+	PendingEffects.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UEffectPlaybackSubsystem::IsTickable() const
+{
+	return PendingEffects.Num() > 0;
+}
+
+TStatId UEffectPlaybackSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEffectPlaybackSubsystem, STATGROUP_Tickables);
+}
+
+void UEffectPlaybackSubsystem::Prewarm(UParticleSystem* Template, int32 Count)
+{
+	if (!Template)
+	{
+		return;
+	}
+
+	TArray<TObjectPtr<UParticleSystemComponent>>& Pool = Pools.FindOrAdd(Template);
+	const int32 Target = FMath::Min(Count, CVarEffectMaxPoolSize.GetValueOnGameThread());
+	while (Pool.Num() < Target)
+	{
+		Pool.Add(CreateComponent(Template));
+	}
+}
+
+void UEffectPlaybackSubsystem::PlayEffect(UParticleSystem* Template, const FVector& Location, const FRotator& Rotation)
+{
+	if (!Template)
+	{
+		return;
+	}
+
+	FPendingEffect& Effect = PendingEffects.AddDefaulted_GetRef();
+	Effect.Template = Template;
+	Effect.Location = Location;
+	Effect.Rotation = Rotation;
+	Effect.RequestTime = GetWorld()->GetTimeSeconds();
+}
+
+void UEffectPlaybackSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_EffectPlaybackTick);
+
+	Viewpoints.Reset();
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (PlayerController && PlayerController->IsLocalController())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			Viewpoints.Add(ViewLocation);
+		}
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	const double MaxDeferSeconds = CVarEffectMaxDeferSeconds.GetValueOnGameThread();
+	int32 Budget = CVarEffectSpawnBudget.GetValueOnGameThread();
+
+	int32 NumProcessed = 0;
+	for (; NumProcessed < PendingEffects.Num(); ++NumProcessed)
+	{
+		const FPendingEffect& Effect = PendingEffects[NumProcessed];
+		UParticleSystem* Template = Effect.Template.Get();
+		if (!Template || Now - Effect.RequestTime > MaxDeferSeconds || !IsWithinCullDistance(Effect.Location))
+		{
+			INC_DWORD_STAT(STAT_EffectsDropped);
+			continue;
+		}
+
+		if (Budget <= 0)
+		{
+			break;
+		}
+
+		UParticleSystemComponent* Component = AcquireComponent(Template);
+		if (!Component)
+		{
+			// Every pooled component is still playing, try again next frame
+			break;
+		}
+
+		Component->SetWorldLocationAndRotation(Effect.Location, Effect.Rotation);
+		Component->ActivateSystem(true);
+		--Budget;
+		INC_DWORD_STAT(STAT_EffectsSpawned);
+	}
+
+	PendingEffects.RemoveAt(0, NumProcessed, false);
+	SET_DWORD_STAT(STAT_EffectsDeferred, PendingEffects.Num());
+}
+
+UParticleSystemComponent* UEffectPlaybackSubsystem::CreateComponent(UParticleSystem* Template)
+{
+	UWorld* World = GetWorld();
+	UParticleSystemComponent* Component = NewObject<UParticleSystemComponent>(World->GetWorldSettings());
+	Component->bAutoDestroy = false;
+	Component->bAutoActivate = false;
+	Component->SetAbsolute(true, true, true);
+	Component->SetTemplate(Template);
+	Component->RegisterComponentWithWorld(World);
+	AllComponents.Add(Component);
+	return Component;
+}
+
+UParticleSystemComponent* UEffectPlaybackSubsystem::AcquireComponent(UParticleSystem* Template)
+{
+	TArray<TObjectPtr<UParticleSystemComponent>>& Pool = Pools.FindOrAdd(Template);
+	for (UParticleSystemComponent* Component : Pool)
+	{
+		if (Component && !Component->IsActive())
+		{
+			return Component;
+		}
+	}
+
+	if (Pool.Num() < CVarEffectMaxPoolSize.GetValueOnGameThread())
+	{
+		return Pool.Add_GetRef(CreateComponent(Template));
+	}
+
+	return nullptr;
+}
+
+bool UEffectPlaybackSubsystem::IsWithinCullDistance(const FVector& Location) const
+{
+	const float CullDistance = CVarEffectCullDistance.GetValueOnGameThread();
+	if (CullDistance <= 0.0f || Viewpoints.Num() == 0)
+	{
+		return true;
+	}
+
+	for (const FVector& Viewpoint : Viewpoints)
+	{
+		if (FVector::DistSquared(Viewpoint, Location) <= FMath::Square(CullDistance))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EffectPlaybackSubsystem.generated.h"
+
+class UParticleSystem;
+class UParticleSystemComponent;
+
+/**
+ * Client-side playback of cosmetic particle effects.
+ * Requests are queued and started from pre-warmed per-template component pools,
+ * at most a fixed number per frame. Requests that are too far from every local
+ * viewpoint or have waited too long are dropped instead of spawned.
+ */
+UCLASS()
+class MULTIPLAYERCOURSE_API UEffectPlaybackSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	// Makes sure at least Count idle components exist for Template
+	void Prewarm(UParticleSystem* Template, int32 Count);
+
+	void PlayEffect(UParticleSystem* Template, const FVector& Location, const FRotator& Rotation = FRotator::ZeroRotator);
+
+private:
+	struct FPendingEffect
+	{
+		TWeakObjectPtr<UParticleSystem> Template;
+		FVector Location;
+		FRotator Rotation;
+		double RequestTime;
+	};
+
+	UParticleSystemComponent* CreateComponent(UParticleSystem* Template);
+	UParticleSystemComponent* AcquireComponent(UParticleSystem* Template);
+	bool IsWithinCullDistance(const FVector& Location) const;
+
+	TMap<TObjectPtr<UParticleSystem>, TArray<TObjectPtr<UParticleSystemComponent>>> Pools;
+
+	// Every pooled component, so they're referenced for GC
+	UPROPERTY()
+	TArray<TObjectPtr<UParticleSystemComponent>> AllComponents;
+
+	TArray<FPendingEffect> PendingEffects;
+	TArray<FVector> Viewpoints;
+};
@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HostTravelTimingSubsystem.h"
+
+void UHostTravelTimingSubsystem::BeginTravel(bool bSeamless)
+{
+	TravelIsSeamless = bSeamless;
+	TravelStartTime = FPlatformTime::Seconds();
+}
+
+void UHostTravelTimingSubsystem::EndTravel()
+{
+	if (TravelStartTime <= 0.0)
+	{
+		return;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("%s travel took %.1f ms"), TravelIsSeamless ? TEXT("Seamless") : TEXT("Hard"),
+		(FPlatformTime::Seconds() - TravelStartTime) * 1000.0);
+	TravelStartTime = 0.0;
+}
@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "HostTravelTimingSubsystem.generated.h"
+
+/**
+ * Times AMultiplayerCourseGameMode::HostLANGame's server travel. Lives on the game instance
+ * because the game mode that starts the travel is gone by the time the destination map's
+ * game mode reports it.
+ */
+UCLASS()
+class MULTIPLAYERCOURSE_API UHostTravelTimingSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void BeginTravel(bool bSeamless);
+
+	// Logs how long the pending travel took, does nothing if none was started
+	void EndTravel();
+
+private:
+	bool TravelIsSeamless = false;
+
+	// FPlatformTime::Seconds() when the travel started, 0 when none is pending
+	double TravelStartTime = 0.0;
+};
@@ -3,3 +3,6 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("MultiplayerCourse"), STATGROUP_MultiplayerCourse, STATCAT_Advanced);
@@ -4,18 +4,26 @@
 #include "Engine/LocalPlayer.h"
 #include "Camera/CameraComponent.h"
 #include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "GameFramework/Controller.h"
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "InputActionValue.h"
+#include "HAL/IConsoleManager.h"
 #include "Net/UnrealNetwork.h"
-#include "Engine/StaticMeshActor.h"
-#include "Kismet/GameplayStatics.h"
+#include "SpherePoolSubsystem.h"
+#include "RPCRateLimitSubsystem.h"
+#include "CosmeticEventSubsystem.h"
 
 DEFINE_LOG_CATEGORY(LogTemplateCharacter);
 
+static TAutoConsoleVariable<bool> CVarServerStripClientComponents(
+	TEXT("MultiplayerCourse.Server.StripClientComponents"),
+	true,
+	TEXT("Dedicated servers skip camera components and pose evaluation on newly spawned characters."));
+
 //////////////////////////////////////////////////////////////////////////
 // AMultiplayerCourseCharacter
 
@@ -53,10 +61,29 @@ AMultiplayerCourseCharacter::AMultiplayerCourseCharacter()
 	FollowCamera->SetupAttachment(CameraBoom, USpringArmComponent::SocketName); // Attach the camera to the end of the boom and let the boom adjust to match the controller orientation
 	FollowCamera->bUsePawnControlRotation = false; // Camera does not rotate relative to arm
 
+	CosmeticEvents = CreateDefaultSubobject<UCosmeticEventComponent>(TEXT("CosmeticEvents"));
+
 	// Note: The skeletal mesh and anim blueprint references on the Mesh component (inherited from Character) 
 	// are set in the derived blueprint asset named ThirdPersonCharacter (to avoid direct content references in C++)
 }
 
+void AMultiplayerCourseCharacter::PreRegisterAllComponents()
+{
+	if (IsRunningDedicatedServer() && CVarServerStripClientComponents.GetValueOnGameThread())
+	{
+		// Nothing looks through the camera on a server, so skip the spring arm's collision traces
+		CameraBoom->bAutoRegister = false;
+		FollowCamera->bAutoRegister = false;
+
+		if (!bServerNeedsBoneData)
+		{
+			GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+		}
+	}
+
+	Super::PreRegisterAllComponents();
+}
+
 void AMultiplayerCourseCharacter::BeginPlay()
 {
 	// Call the base class  
@@ -133,7 +160,18 @@ void AMultiplayerCourseCharacter::Look(const FInputActionValue& Value)
 }
 
 // RPCs
-void AMultiplayerCourseCharacter::ServerRPCFunction_Implementation(int MyArg)
+void AMultiplayerCourseCharacter::ServerRPCFunction(int MyArg)
+{
+	if (!HasAuthority())
+	{
+		URPCRateLimitSubsystem* RateLimiter = GetWorld()->GetSubsystem<URPCRateLimitSubsystem>();
+		if (RateLimiter && RateLimiter->ConsumeTokens(this) == 0) return;
+	}
+
+	ServerRPCFunctionPacked(FNetPercent(MyArg));
+}
+
+void AMultiplayerCourseCharacter::ServerRPCFunctionPacked_Implementation(FNetPercent MyArg)
 {
 	if (HasAuthority())
 	{
@@ -144,55 +182,79 @@ void AMultiplayerCourseCharacter::ServerRPCFunction_Implementation(int MyArg)
 
 #if 0
 		GEngine->AddOnScreenDebugMessage(-1, 15.0f, FColor::Green, 
-			FString::Printf(TEXT("MyArg: %d"), MyArg));
+			FString::Printf(TEXT("MyArg: %d"), MyArg.Value));
 #endif
 
-		if (!SphereMesh) return;
+		URPCRateLimitSubsystem* RateLimiter = GetWorld()->GetSubsystem<URPCRateLimitSubsystem>();
+		if (RateLimiter && RateLimiter->ConsumeTokens(this) == 0) return;
 
-		FActorSpawnParameters SpawnParameters;
-		SpawnParameters.Owner = this;
-		AStaticMeshActor *StaticMeshActor = GetWorld()->SpawnActor<AStaticMeshActor>(SpawnParameters);
-		if (StaticMeshActor)
-		{
-			//StaticMeshActor->SetOwner(this);
-			StaticMeshActor->SetReplicates(true);
-			StaticMeshActor->SetReplicateMovement(true);
-			StaticMeshActor->SetMobility(EComponentMobility::Movable);
-
-			FVector SpawnLocation = GetActorLocation() + GetActorRotation().Vector() * 100.0f + GetActorUpVector() * 50.0f;
-			StaticMeshActor->SetActorLocation(SpawnLocation);
-
-			UStaticMeshComponent *StaticMeshComponent = StaticMeshActor->GetStaticMeshComponent();
-			if (StaticMeshComponent)
-			{
-				StaticMeshComponent->SetIsReplicated(true);
-				StaticMeshComponent->SetSimulatePhysics(true);
-				
-				if (SphereMesh)
-				{
-					StaticMeshComponent->SetStaticMesh(SphereMesh);
-				}
-			}
-		}
+		SpawnSphere();
 	}
 }
 
-bool AMultiplayerCourseCharacter::ServerRPCFunction_Validate(int MyArg)
+void AMultiplayerCourseCharacter::RequestSpawnSphere()
 {
-	if (MyArg >= 0 && MyArg <= 100)
+	if (PendingSpawnRequests == 0)
 	{
-		return true;
+		GetWorldTimerManager().SetTimerForNextTick(this, &AMultiplayerCourseCharacter::FlushSpawnRequests);
 	}
 
-	return false;
+	PendingSpawnRequests = FMath::Min(PendingSpawnRequests + 1, MaxSpawnBatch);
+}
+
+void AMultiplayerCourseCharacter::FlushSpawnRequests()
+{
+	int32 Count = PendingSpawnRequests;
+	PendingSpawnRequests = 0;
+
+	// The server checks again, this only saves sending requests it would drop
+	URPCRateLimitSubsystem* RateLimiter = !HasAuthority() ? GetWorld()->GetSubsystem<URPCRateLimitSubsystem>() : nullptr;
+	if (RateLimiter)
+	{
+		Count = RateLimiter->ConsumeTokens(this, Count);
+	}
+
+	if (Count > 0)
+	{
+		ServerRPCSpawnSpheres(FNetSpawnCount(Count));
+	}
+}
+
+void AMultiplayerCourseCharacter::ServerRPCSpawnSpheres_Implementation(FNetSpawnCount Count)
+{
+	int32 Granted = Count.Value;
+	if (URPCRateLimitSubsystem* RateLimiter = GetWorld()->GetSubsystem<URPCRateLimitSubsystem>())
+	{
+		Granted = RateLimiter->ConsumeTokens(this, Count.Value);
+	}
+
+	for (int32 Idx = 0; Idx < Granted; ++Idx)
+	{
+		SpawnSphere();
+	}
+}
+
+void AMultiplayerCourseCharacter::SpawnSphere()
+{
+	if (!SphereMesh) return;
+
+	if (USpherePoolSubsystem* SpherePool = GetWorld()->GetSubsystem<USpherePoolSubsystem>())
+	{
+		FVector SpawnLocation = GetActorLocation() + GetActorRotation().Vector() * 100.0f + GetActorUpVector() * 50.0f;
+		SpherePool->AcquireSphere(SphereMesh, SpawnLocation, this);
+
+		if (UCosmeticEventSubsystem* CosmeticEventSubsystem = GetWorld()->GetSubsystem<UCosmeticEventSubsystem>())
+		{
+			CosmeticEventSubsystem->QueueForRelevant(this, ParticleEffect, SpawnLocation);
+		}
+	}
 }
 
-void AMultiplayerCourseCharacter::ClientRPCFunction_Implementation()
+void AMultiplayerCourseCharacter::ClientRPCFunction()
 {
-	if (ParticleEffect)
+	if (UCosmeticEventSubsystem* CosmeticEventSubsystem = GetWorld()->GetSubsystem<UCosmeticEventSubsystem>())
 	{
 		FVector SpawnLocation = GetActorLocation();
-		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ParticleEffect, SpawnLocation, 
-			FRotator::ZeroRotator, true, EPSCPoolMethod::AutoRelease);
+		CosmeticEventSubsystem->QueueForOwner(this, ParticleEffect, SpawnLocation);
 	}
 }
\ No newline at end of file
@@ -6,10 +6,12 @@
 #include "GameFramework/Character.h"
 #include "Logging/LogMacros.h"
 #include "Particles/ParticleSystem.h"
+#include "NetQuantizedTypes.h"
 #include "MultiplayerCourseCharacter.generated.h"
 
 class USpringArmComponent;
 class UCameraComponent;
+class UCosmeticEventComponent;
 class UInputMappingContext;
 class UInputAction;
 struct FInputActionValue;
@@ -28,6 +30,10 @@ class AMultiplayerCourseCharacter : public ACharacter
 	/** Follow camera */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	UCameraComponent* FollowCamera;
+
+	/** Receives this player's bundled cosmetic events */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Network, meta = (AllowPrivateAccess = "true"))
+	UCosmeticEventComponent* CosmeticEvents;
 	
 	/** MappingContext */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (AllowPrivateAccess = "true"))
@@ -65,22 +71,53 @@ protected:
 	// To add mapping context
 	virtual void BeginPlay();
 
+	// Keeps camera components from registering on dedicated servers, which never render
+	virtual void PreRegisterAllComponents() override;
+
+	// Dedicated servers only update montages unless this is set, e.g. for hit detection against bones
+	UPROPERTY(EditDefaultsOnly, Category = Server)
+	bool bServerNeedsBoneData = false;
+
 public:
 	/** Returns CameraBoom subobject **/
 	FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
 	/** Returns FollowCamera subobject **/
 	FORCEINLINE class UCameraComponent* GetFollowCamera() const { return FollowCamera; }
 
-	UFUNCTION(Server, Reliable, WithValidation, BlueprintCallable)
+	// Blueprint entry point for ServerRPCFunctionPacked, MyArg must be 0 to 100.
+	// Clients spend a rate limit token before sending, so a flood never reaches the reliable buffer.
+	UFUNCTION(BlueprintCallable)
 	void ServerRPCFunction(int MyArg);
 
+	// The range is checked while the parameter is read, so there is no _Validate
+	UFUNCTION(Server, Reliable)
+	void ServerRPCFunctionPacked(FNetPercent MyArg);
+
+	// Queues a sphere spawn; all requests made within one frame are sent as a single ServerRPCSpawnSpheres
+	UFUNCTION(BlueprintCallable)
+	void RequestSpawnSphere();
+
+	UFUNCTION(Server, Unreliable)
+	void ServerRPCSpawnSpheres(FNetSpawnCount Count);
+
+	// Largest Count accepted by ServerRPCSpawnSpheres
+	static constexpr int32 MaxSpawnBatch = FNetSpawnCount::Max;
+
 	UPROPERTY(EditAnywhere)
 	UStaticMesh* SphereMesh;
 
-	UFUNCTION(Client, Reliable, BlueprintCallable)
+	// Plays ParticleEffect for the owning player through UCosmeticEventSubsystem instead of a reliable Client RPC
+	UFUNCTION(BlueprintCallable)
 	void ClientRPCFunction();
 
+	// Also played where each sphere spawns, for every player this character is relevant to
 	UPROPERTY(EditAnywhere)
 	UParticleSystem *ParticleEffect;
+
+private:
+	void SpawnSphere();
+	void FlushSpawnRequests();
+
+	int32 PendingSpawnRequests = 0;
 };
 
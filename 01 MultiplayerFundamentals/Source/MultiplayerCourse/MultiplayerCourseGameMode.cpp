@@ -2,7 +2,9 @@
 
 #include "MultiplayerCourseGameMode.h"
 #include "MultiplayerCourseCharacter.h"
+#include "HostTravelTimingSubsystem.h"
 #include "UObject/ConstructorHelpers.h"
+#include "EngineUtils.h"
 
 AMultiplayerCourseGameMode::AMultiplayerCourseGameMode()
 {
@@ -12,18 +14,70 @@ AMultiplayerCourseGameMode::AMultiplayerCourseGameMode()
 	{
 		DefaultPawnClass = PlayerPawnBPClass.Class;
 	}
+
+	// Keep clients connected and reuse loaded assets when the listen server changes maps
+	bUseSeamlessTravel = true;
+
+	LANJoinAddress = TEXT("127.0.0.1");
 }
 
 void AMultiplayerCourseGameMode::HostLANGame()
 {
-	GetWorld()->ServerTravel("/Game/ThirdPerson/Maps/ThirdPersonMap?listen");
+	// Seamless travel can only be used once we're already listening
+	const bool bSeamless = GetNetMode() == NM_ListenServer && bUseSeamlessTravel;
+
+	// Reported by the game mode of the destination map
+	if (UHostTravelTimingSubsystem* TravelTiming = GetGameInstance()->GetSubsystem<UHostTravelTimingSubsystem>())
+	{
+		TravelTiming->BeginTravel(bSeamless);
+	}
+
+	if (bSeamless)
+	{
+		GetWorld()->ServerTravel("/Game/ThirdPerson/Maps/ThirdPersonMap");
+	}
+	else
+	{
+		GetWorld()->ServerTravel("/Game/ThirdPerson/Maps/ThirdPersonMap?listen");
+	}
+}
+
+void AMultiplayerCourseGameMode::StartPlay()
+{
+	Super::StartPlay();
+
+	if (UHostTravelTimingSubsystem* TravelTiming = GetGameInstance()->GetSubsystem<UHostTravelTimingSubsystem>())
+	{
+		TravelTiming->EndTravel();
+	}
+}
+
+void AMultiplayerCourseGameMode::GetSeamlessTravelActorList(bool bToTransition, TArray<AActor*>& ActorList)
+{
+	Super::GetSeamlessTravelActorList(bToTransition, ActorList);
+
+	for (const TSubclassOf<AActor>& ActorClass : SeamlessTravelActorClasses)
+	{
+		if (!ActorClass)
+		{
+			continue;
+		}
+
+		for (TActorIterator<AActor> It(GetWorld(), ActorClass); It; ++It)
+		{
+			ActorList.AddUnique(*It);
+		}
+	}
 }
 
 void AMultiplayerCourseGameMode::JoinLANGame()
 {
+	FString Address = LANJoinAddress;
+	FParse::Value(FCommandLine::Get(), TEXT("JoinAddress="), Address);
+
 	APlayerController *PlayerController = GetGameInstance()->GetFirstLocalPlayerController();
-	if (PlayerController)
+	if (PlayerController && !Address.IsEmpty())
 	{
-		PlayerController->ClientTravel("192.168.1.51", TRAVEL_Absolute);
+		PlayerController->ClientTravel(Address, TRAVEL_Absolute);
 	}
 }
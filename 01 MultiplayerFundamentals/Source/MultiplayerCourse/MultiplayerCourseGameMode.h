@@ -19,6 +19,18 @@ public:
 
 	UFUNCTION(BlueprintCallable)
 	void JoinLANGame();
+
+	virtual void StartPlay() override;
+
+	virtual void GetSeamlessTravelActorList(bool bToTransition, TArray<AActor*>& ActorList) override;
+
+	// Actors of these classes are carried across seamless travel, in addition to the controllers and player states
+	UPROPERTY(EditDefaultsOnly, Category = Travel)
+	TArray<TSubclassOf<AActor>> SeamlessTravelActorClasses;
+
+	// Address JoinLANGame connects to, overridden by -JoinAddress=<address> on the command line
+	UPROPERTY(Config, EditDefaultsOnly, Category = Travel)
+	FString LANJoinAddress;
 };
 
 
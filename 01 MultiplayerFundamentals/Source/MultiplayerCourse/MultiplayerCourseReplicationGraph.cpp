@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MultiplayerCourseReplicationGraph.h"
+#include "MyBox.h"
+#include "NetRelevancyPolicyComponent.h"
+#include "ReplicatedPhysicsSphere.h"
+
+void UMultiplayerCourseReplicationGraph::InitClassRepNodePolicies()
+{
+	// Both only start replicating in BeginPlay or after spawning, so their CDOs don't say so
+	SetClassRepNodePolicy(AMyBox::StaticClass(), EMultiplayerClassRepNodeMapping::Spatialize_Dormancy);
+	SetClassRepNodePolicy(AReplicatedPhysicsSphere::StaticClass(), EMultiplayerClassRepNodeMapping::Spatialize_Dynamic);
+}
+
+void UMultiplayerCourseReplicationGraph::ApplyRelevancyPolicy(const AActor* Actor, FGlobalActorReplicationInfo& GlobalInfo) const
+{
+	if (const UNetRelevancyPolicyComponent* Policy = Actor ? Actor->FindComponentByClass<UNetRelevancyPolicyComponent>() : nullptr)
+	{
+		ApplyRelevancySettings(GlobalInfo, Policy->NetCullDistance, Policy->NetUpdateFrequency);
+	}
+}
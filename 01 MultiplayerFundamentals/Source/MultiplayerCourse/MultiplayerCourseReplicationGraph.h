@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MultiplayerReplicationGraph.h"
+#include "MultiplayerCourseReplicationGraph.generated.h"
+
+/**
+ * Replication graph for MultiplayerCourse. The shared graph's spatial grid covers characters,
+ * spheres and boxes; this only maps the classes that start replicating after they spawn.
+ * Enabled through ReplicationDriverClassName in DefaultEngine.ini.
+ */
+UCLASS(Transient, Config = Engine)
+class MULTIPLAYERCOURSE_API UMultiplayerCourseReplicationGraph : public UMultiplayerReplicationGraph
+{
+	GENERATED_BODY()
+
+protected:
+	virtual void InitClassRepNodePolicies() override;
+	virtual void ApplyRelevancyPolicy(const AActor* Actor, FGlobalActorReplicationInfo& GlobalInfo) const override;
+};
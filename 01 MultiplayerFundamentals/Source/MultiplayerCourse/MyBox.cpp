@@ -3,16 +3,25 @@
 
 #include "MyBox.h"
 #include "Net/UnrealNetwork.h"
-#include "Kismet/GameplayStatics.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "GameFramework/GameStateBase.h"
+#include "EffectPlaybackSubsystem.h"
 
 // Sets default values
 AMyBox::AMyBox()
 {
- 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+ 	// Tick() does nothing, explosions run on ExplodeTimer
+	PrimaryActorTick.bCanEverTick = false;
 
 	//bReplicates = true;
 	ReplicatedVar = 100.0f;
+
+	// Explosions are visible from a distance, but nobody needs the box across the level
+	NetRelevancyPolicy = CreateDefaultSubobject<UNetRelevancyPolicyComponent>(TEXT("Net Relevancy Policy"));
+	NetRelevancyPolicy->NetCullDistance = 7500.0f;
+	NetRelevancyPolicy->NetUpdateFrequency = 10.0f;
+
+	Significance = CreateDefaultSubobject<USignificanceComponent>(TEXT("Significance"));
 }
 
 // Called when the game starts or when spawned
@@ -23,12 +32,45 @@ void AMyBox::BeginPlay()
 	SetReplicates(true);
 	SetReplicateMovement(true);
 
-	if (HasAuthority())
+	if (bUseNetDormancy)
+	{
+		// Sent once on channel open, then only on FlushNetDormancy
+		SetNetDormancy(DORM_DormantAll);
+	}
+
+	UEffectPlaybackSubsystem* EffectPlayback = GetWorld()->GetSubsystem<UEffectPlaybackSubsystem>();
+	if (EffectPlayback && ExplodeInterval > 0.0f)
 	{
-		GetWorld()->GetTimerManager().SetTimer(TestTimer, this, &AMyBox::MulticastRPCExplode, 2.0f, false);
+		EffectPlayback->Prewarm(ExplosionEffect, 4);
+	}
+
+	if (HasAuthority() && ExplodeInterval > 0.0f)
+	{
+		const AGameStateBase* GameState = GetWorld()->GetGameState();
+		const float ServerTime = GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+
+		ExplodeSchedule.ServerTime = ServerTime + ExplodeInterval;
+		ExplodeSchedule.Interval = ExplodeInterval;
+		MARK_PROPERTY_DIRTY_FROM_NAME(AMyBox, ExplodeSchedule, this);
+		FlushNetDormancy();
+
+		OnRep_ExplodeSchedule();
 	}
 }
 
+void AMyBox::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UTimerWheelSubsystem* TimerWheel = GetWorld()->GetSubsystem<UTimerWheelSubsystem>())
+	{
+		TimerWheel->ClearTimer(TestTimer);
+		TimerWheel->ClearTimer(ExplodeTimer);
+	}
+
+	GetWorld()->GameStateSetEvent.Remove(GameStateSetHandle);
+
+	Super::EndPlay(EndPlayReason);
+}
+
 // Called every frame
 void AMyBox::Tick(float DeltaTime)
 {
@@ -67,7 +109,10 @@ void AMyBox::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimePr
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(AMyBox, ReplicatedVar);
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AMyBox, ReplicatedVar, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AMyBox, ExplodeSchedule, Params);
 }
 
 void AMyBox::DecreaseReplicatedVar()
@@ -75,31 +120,86 @@ void AMyBox::DecreaseReplicatedVar()
 	if (HasAuthority())
 	{
 		ReplicatedVar -= 1.0f;
+		MARK_PROPERTY_DIRTY_FROM_NAME(AMyBox, ReplicatedVar, this);
 		OnRep_ReplicatedVar();
+		FlushNetDormancy();
 
-		if (ReplicatedVar > 0)
+		UTimerWheelSubsystem* TimerWheel = GetWorld()->GetSubsystem<UTimerWheelSubsystem>();
+		if (TimerWheel && ReplicatedVar > 0)
 		{
-			GetWorld()->GetTimerManager().SetTimer(TestTimer, this, &AMyBox::DecreaseReplicatedVar, 2.0f, false);
+			TimerWheel->SetTimer(TestTimer, this, &AMyBox::DecreaseReplicatedVar, 2.0f, false);
 		}
 	}
 }
 
-void AMyBox::MulticastRPCExplode_Implementation()
+void AMyBox::OnRep_ExplodeSchedule()
 {
-	if (HasAuthority())
+	// A dedicated server has nothing to show, so it doesn't need a timer at all
+	if (IsRunningDedicatedServer())
 	{
-		//GEngine->AddOnScreenDebugMessage(-1, 3.0f, FColor::Red, TEXT("Server: MulticastRPCExplode_Implementation"));
-		GetWorld()->GetTimerManager().SetTimer(TestTimer, this, &AMyBox::MulticastRPCExplode, 2.0f, false);
+		return;
 	}
-	else
+
+	ScheduleNextExplosion();
+}
+
+void AMyBox::ScheduleNextExplosion()
+{
+	UTimerWheelSubsystem* TimerWheel = GetWorld()->GetSubsystem<UTimerWheelSubsystem>();
+	if (!TimerWheel)
+	{
+		return;
+	}
+
+	if (ExplodeSchedule.Interval <= 0.0f)
+	{
+		TimerWheel->ClearTimer(ExplodeTimer);
+		return;
+	}
+
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	if (!GameState)
+	{
+		if (!GameStateSetHandle.IsValid())
+		{
+			GameStateSetHandle = GetWorld()->GameStateSetEvent.AddUObject(this, &AMyBox::OnGameStateSet);
+		}
+		return;
+	}
+
+	// Late joiners land mid-schedule and just wait for the next explosion
+	const float Now = GameState->GetServerWorldTimeSeconds();
+	const float Elapsed = FMath::Max(Now - ExplodeSchedule.ServerTime, 0.0f);
+	int32 NextIndex = FMath::CeilToInt(Elapsed / ExplodeSchedule.Interval);
+	if (LastExplosionIndex != INDEX_NONE && NextIndex <= LastExplosionIndex)
 	{
-		//GEngine->AddOnScreenDebugMessage(-1, 3.0f, FColor::Blue, TEXT("Client: MulticastRPCExplode_Implementation"));
+		NextIndex = LastExplosionIndex + 1;
 	}
 
-	if (!IsRunningDedicatedServer())
+	const float NextTime = ExplodeSchedule.ServerTime + NextIndex * ExplodeSchedule.Interval;
+	PendingExplosionIndex = NextIndex;
+
+	TimerWheel->SetTimer(ExplodeTimer, this, &AMyBox::Explode, FMath::Max(NextTime - Now, KINDA_SMALL_NUMBER), false);
+}
+
+void AMyBox::OnGameStateSet(AGameStateBase* GameState)
+{
+	GetWorld()->GameStateSetEvent.Remove(GameStateSetHandle);
+	GameStateSetHandle.Reset();
+
+	// The game state is set as it spawns, its replicated server time is only applied after that
+	GetWorldTimerManager().SetTimerForNextTick(this, &AMyBox::ScheduleNextExplosion);
+}
+
+void AMyBox::Explode()
+{
+	UEffectPlaybackSubsystem* EffectPlayback = GetWorld()->GetSubsystem<UEffectPlaybackSubsystem>();
+	if (EffectPlayback && Significance->ShouldPlayEffects())
 	{
 		FVector SpawnLocation = GetActorLocation() + FVector(0, 0, 100.0f);
-		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ExplosionEffect, SpawnLocation, 
-			FRotator::ZeroRotator, true, EPSCPoolMethod::AutoRelease);
+		EffectPlayback->PlayEffect(ExplosionEffect, SpawnLocation);
 	}
-}
\ No newline at end of file
+
+	LastExplosionIndex = PendingExplosionIndex;
+	ScheduleNextExplosion();
+}
@@ -5,8 +5,27 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "Particles/ParticleSystem.h"
+#include "NetRelevancyPolicyComponent.h"
+#include "SignificanceComponent.h"
+#include "TimerWheelSubsystem.h"
 #include "MyBox.generated.h"
 
+class AGameStateBase;
+
+// Explosions repeat every Interval seconds, explosion number 0 going off at ServerTime
+USTRUCT()
+struct FExplodeSchedule
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	float ServerTime = 0.0f;
+
+	// 0 disables explosions
+	UPROPERTY()
+	float Interval = 0.0f;
+};
+
 UCLASS()
 class MULTIPLAYERCOURSE_API AMyBox : public AActor
 {
@@ -20,6 +39,9 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	// Timer wheel timers aren't cleared with the actor like FTimerManager ones
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 public:	
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
@@ -34,10 +56,45 @@ public:
 
 	void DecreaseReplicatedVar();
 
-	FTimerHandle TestTimer;
+	FWheelTimerHandle TestTimer;
+
+	// Keep the box dormant between state changes instead of comparing it every replication pass
+	UPROPERTY(EditAnywhere, Category = Replication)
+	bool bUseNetDormancy = true;
+
+	UPROPERTY(VisibleAnywhere, Category = Replication)
+	UNetRelevancyPolicyComponent* NetRelevancyPolicy;
+
+	// Explosions are skipped for boxes in the Low and Culled tiers
+	UPROPERTY(VisibleAnywhere, Category = Performance)
+	USignificanceComponent* Significance;
+
+	// Seconds between explosions, replicated once through ExplodeSchedule
+	UPROPERTY(EditAnywhere)
+	float ExplodeInterval = 2.0f;
+
+	// Replicated once when set, every machine then plays the explosions on its own timer
+	UPROPERTY(ReplicatedUsing = OnRep_ExplodeSchedule)
+	FExplodeSchedule ExplodeSchedule;
+
+	UFUNCTION()
+	void OnRep_ExplodeSchedule();
+
+	// Arms ExplodeTimer for the next explosion in ExplodeSchedule after the current server time.
+	// Waits for the game state on clients, there is no server time before it has replicated.
+	void ScheduleNextExplosion();
+
+	void OnGameStateSet(AGameStateBase* GameState);
+
+	FDelegateHandle GameStateSetHandle;
+
+	void Explode();
+
+	FWheelTimerHandle ExplodeTimer;
 
-	UFUNCTION(NetMulticast, Reliable)
-	void MulticastRPCExplode();
+	// Local bookkeeping so an explosion is never played twice when the timer fires slightly early
+	int32 PendingExplosionIndex = INDEX_NONE;
+	int32 LastExplosionIndex = INDEX_NONE;
 
 	UPROPERTY(EditAnywhere)
 	UParticleSystem *ExplosionEffect;
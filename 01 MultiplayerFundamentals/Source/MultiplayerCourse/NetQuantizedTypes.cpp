@@ -0,0 +1,73 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NetQuantizedTypes.h"
+#include "MultiplayerCourse.h"
+#include "HAL/IConsoleManager.h"
+#include "Serialization/BitWriter.h"
+
+DECLARE_CYCLE_STAT(TEXT("Quantized Param Serialize"), STAT_QuantizedParamSerialize, STATGROUP_MultiplayerCourse);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Quantized Param Bits Sent"), STAT_QuantizedParamBitsSent, STATGROUP_MultiplayerCourse);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Quantized Param Bits Saved"), STAT_QuantizedParamBitsSaved, STATGROUP_MultiplayerCourse);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Quantized Params Rejected"), STAT_QuantizedParamsRejected, STATGROUP_MultiplayerCourse);
+
+bool NetQuantize::SerializeRangedInt(FArchive& Ar, int32& Value, int32 Min, int32 Max, int32 BaselineBits)
+{
+	SCOPE_CYCLE_COUNTER(STAT_QuantizedParamSerialize);
+
+	check(Min <= Max);
+	const uint32 Range = (uint32)((int64)Max - Min);
+	const uint32 NumBits = FMath::CeilLogTwo64((uint64)Range + 1);
+
+	uint32 Encoded = 0;
+	if (Ar.IsSaving())
+	{
+		if (Value < Min || Value > Max)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Sending %d outside of [%d, %d], clamped"), Value, Min, Max);
+		}
+		Encoded = (uint32)((int64)FMath::Clamp(Value, Min, Max) - Min);
+
+		INC_DWORD_STAT_BY(STAT_QuantizedParamBitsSent, NumBits);
+		INC_DWORD_STAT_BY(STAT_QuantizedParamBitsSaved, FMath::Max(BaselineBits - (int32)NumBits, 0));
+	}
+
+	if (NumBits > 0)
+	{
+		Ar.SerializeBits(&Encoded, NumBits);
+	}
+
+	if (Ar.IsLoading())
+	{
+		if (Ar.IsError() || Encoded > Range)
+		{
+			Ar.SetError();
+			INC_DWORD_STAT(STAT_QuantizedParamsRejected);
+			return false;
+		}
+		Value = (int32)((int64)Min + Encoded);
+	}
+
+	return true;
+}
+
+template<typename T>
+static void LogQuantizedBits(const TCHAR* TypeName, const TCHAR* BaselineName)
+{
+	FBitWriter Writer(0, true);
+	bool bSuccess = true;
+	T Value(T::Max);
+	Value.NetSerialize(Writer, nullptr, bSuccess);
+
+	UE_LOG(LogTemp, Log, TEXT("%s: %lld bits for [%d, %d], the %s it replaced took %d"),
+		TypeName, Writer.GetNumBits(), T::Min, T::Max, BaselineName, T::BaselineBits);
+}
+
+static FAutoConsoleCommand NetQuantizeBitsCommand(
+	TEXT("MultiplayerCourse.NetQuantize.Bits"),
+	TEXT("Logs how many bits each quantized RPC parameter type is sent in, next to the type it replaced."),
+	FConsoleCommandDelegate::CreateStatic([]()
+	{
+		LogQuantizedBits<FNetPercent>(TEXT("FNetPercent"), TEXT("int32"));
+		LogQuantizedBits<FNetSpawnCount>(TEXT("FNetSpawnCount"), TEXT("uint8"));
+	}));
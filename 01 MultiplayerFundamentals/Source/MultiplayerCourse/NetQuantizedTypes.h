@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NetQuantizedTypes.generated.h"
+
+namespace NetQuantize
+{
+	// Writes Value - Min in the fewest bits that hold Max - Min. A loaded value outside [Min, Max]
+	// puts Ar in an error state, which closes the connection just like a failed _Validate.
+	// BaselineBits is the size of the type the value replaced, only used for the Bits Saved stat.
+	MULTIPLAYERCOURSE_API bool SerializeRangedInt(FArchive& Ar, int32& Value, int32 Min, int32 Max, int32 BaselineBits = 32);
+}
+
+// 0 to 100, sent in 7 bits
+USTRUCT(BlueprintType)
+struct FNetPercent
+{
+	GENERATED_BODY()
+
+	static constexpr int32 Min = 0;
+	static constexpr int32 Max = 100;
+
+	// Replaced an int parameter
+	static constexpr int32 BaselineBits = 32;
+
+	FNetPercent() = default;
+	explicit FNetPercent(int32 InValue) : Value(InValue) {}
+
+	UPROPERTY(BlueprintReadWrite, Category = Net)
+	int32 Value = 0;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+	{
+		bOutSuccess = NetQuantize::SerializeRangedInt(Ar, Value, Min, Max, BaselineBits);
+		return true;
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FNetPercent> : public TStructOpsTypeTraitsBase2<FNetPercent>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+// Number of spheres in one spawn batch, 1 to 16, sent in 4 bits
+USTRUCT()
+struct FNetSpawnCount
+{
+	GENERATED_BODY()
+
+	static constexpr int32 Min = 1;
+	static constexpr int32 Max = 16;
+
+	// Replaced a uint8 parameter
+	static constexpr int32 BaselineBits = 8;
+
+	FNetSpawnCount() = default;
+	explicit FNetSpawnCount(int32 InValue) : Value(InValue) {}
+
+	UPROPERTY()
+	int32 Value = Min;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+	{
+		bOutSuccess = NetQuantize::SerializeRangedInt(Ar, Value, Min, Max, BaselineBits);
+		return true;
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FNetSpawnCount> : public TStructOpsTypeTraitsBase2<FNetSpawnCount>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
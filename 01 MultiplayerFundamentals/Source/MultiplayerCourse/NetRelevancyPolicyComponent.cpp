@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NetRelevancyPolicyComponent.h"
+
+UNetRelevancyPolicyComponent::UNetRelevancyPolicyComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	NetCullDistance = 0.0f;
+	NetUpdateFrequency = 0.0f;
+	MinNetUpdateFrequency = 0.0f;
+	NetPriority = 0.0f;
+}
+
+void UNetRelevancyPolicyComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	AActor* Owner = GetOwner();
+	if (!Owner->HasAuthority())
+	{
+		return;
+	}
+
+	if (NetCullDistance > 0.0f)
+	{
+		Owner->NetCullDistanceSquared = FMath::Square(NetCullDistance);
+	}
+	if (NetUpdateFrequency > 0.0f)
+	{
+		Owner->NetUpdateFrequency = NetUpdateFrequency;
+	}
+	if (MinNetUpdateFrequency > 0.0f)
+	{
+		Owner->MinNetUpdateFrequency = MinNetUpdateFrequency;
+	}
+	if (NetPriority > 0.0f)
+	{
+		Owner->NetPriority = NetPriority;
+	}
+}
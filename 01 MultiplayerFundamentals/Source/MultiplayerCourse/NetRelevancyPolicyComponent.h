@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "NetRelevancyPolicyComponent.generated.h"
+
+/**
+ * Per-class network relevancy and priority settings.
+ * Applies cull distance, update frequency and priority to the owner when play begins,
+ * so each connection only pays for the replicated actors near its player. The replication
+ * graph reads the same settings when the owner is routed, so actors spawned at runtime
+ * must get the component before SetReplicates(true).
+ */
+UCLASS(ClassGroup = (Network), meta = (BlueprintSpawnableComponent))
+class MULTIPLAYERCOURSE_API UNetRelevancyPolicyComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UNetRelevancyPolicyComponent();
+
+	// Beyond this distance the owner isn't relevant; 0 keeps the owner's own setting
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Relevancy)
+	float NetCullDistance;
+
+	// 0 keeps the owner's own setting
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Relevancy)
+	float NetUpdateFrequency;
+
+	// 0 keeps the owner's own setting
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Relevancy)
+	float MinNetUpdateFrequency;
+
+	// 0 keeps the owner's own setting
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Relevancy)
+	float NetPriority;
+
+protected:
+	virtual void BeginPlay() override;
+};
@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RPCRateLimitSubsystem.h"
+#include "MultiplayerCourse.h"
+#include "Engine/NetConnection.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Server RPCs Rate Limited"), STAT_RPCRateLimited, STATGROUP_MultiplayerCourse);
+
+static TAutoConsoleVariable<float> CVarRPCRateLimitPerSecond(
+	TEXT("MultiplayerCourse.RPCRateLimit.TokensPerSecond"),
+	10.0f,
+	TEXT("Tokens refilled per second for each client connection."));
+
+static TAutoConsoleVariable<float> CVarRPCRateLimitBurst(
+	TEXT("MultiplayerCourse.RPCRateLimit.Burst"),
+	20.0f,
+	TEXT("Maximum tokens a client connection can bank."));
+
+bool URPCRateLimitSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && Super::ShouldCreateSubsystem(Outer);
+}
+
+int32 URPCRateLimitSubsystem::ConsumeTokens(const AActor* Caller, int32 Requested)
+{
+	UNetConnection* Connection = Caller ? Caller->GetNetConnection() : nullptr;
+	if (!Connection || Requested <= 0)
+	{
+		return Requested;
+	}
+
+	const double Now = GetWorld()->GetRealTimeSeconds();
+	const float Burst = CVarRPCRateLimitBurst.GetValueOnGameThread();
+
+	FTokenBucket* Bucket = Buckets.Find(Connection);
+	if (!Bucket)
+	{
+		// Drop buckets of connections that have gone away before adding a new one
+		for (auto It = Buckets.CreateIterator(); It; ++It)
+		{
+			if (!It.Key().IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		Bucket = &Buckets.Add(Connection);
+		Bucket->Tokens = Burst;
+		Bucket->LastRefillTime = Now;
+	}
+
+	const float Refill = (Now - Bucket->LastRefillTime) * CVarRPCRateLimitPerSecond.GetValueOnGameThread();
+	Bucket->Tokens = FMath::Min(Bucket->Tokens + Refill, Burst);
+	Bucket->LastRefillTime = Now;
+
+	const int32 Granted = FMath::Clamp(FMath::FloorToInt(Bucket->Tokens), 0, Requested);
+	Bucket->Tokens -= Granted;
+
+	if (Granted < Requested)
+	{
+		NumDropped += Requested - Granted;
+		INC_DWORD_STAT_BY(STAT_RPCRateLimited, Requested - Granted);
+	}
+
+	return Granted;
+}
@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "RPCRateLimitSubsystem.generated.h"
+
+class UNetConnection;
+
+/**
+ * Per-connection token buckets for throttling server RPCs.
+ * Server RPC implementations ask for tokens before doing any work and drop
+ * the call when the owning connection has used up its budget. Clients ask their
+ * own bucket for the connection to the server before sending, so a reliable RPC
+ * over budget is dropped locally instead of filling the reliable buffer.
+ */
+UCLASS()
+class MULTIPLAYERCOURSE_API URPCRateLimitSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	// Takes up to Requested tokens from the bucket of Caller's connection and returns how many were granted.
+	// Calls that don't come from a remote connection (e.g. the listen server host) are never limited.
+	int32 ConsumeTokens(const AActor* Caller, int32 Requested = 1);
+
+	int32 GetNumDropped() const { return NumDropped; }
+
+private:
+	struct FTokenBucket
+	{
+		float Tokens = 0.0f;
+		double LastRefillTime = 0.0;
+	};
+
+	TMap<TWeakObjectPtr<UNetConnection>, FTokenBucket> Buckets;
+
+	int32 NumDropped = 0;
+};
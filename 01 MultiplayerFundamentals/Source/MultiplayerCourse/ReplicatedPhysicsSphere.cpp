@@ -0,0 +1,316 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ReplicatedPhysicsSphere.h"
+#include "MultiplayerCourse.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "GameFramework/GameStateBase.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Physics Sphere State Updates"), STAT_PhysicsSphereStateUpdates, STATGROUP_MultiplayerCourse);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Physics Sphere Sleep Events"), STAT_PhysicsSphereSleepEvents, STATGROUP_MultiplayerCourse);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Physics Sphere Extrapolations"), STAT_PhysicsSphereExtrapolations, STATGROUP_MultiplayerCourse);
+
+static TAutoConsoleVariable<bool> CVarPhysicsSphereInterpolate(
+	TEXT("MultiplayerCourse.PhysicsSphere.Interpolate"),
+	true,
+	TEXT("Clients render spheres from a snapshot buffer instead of snapping to every update."));
+
+static TAutoConsoleVariable<float> CVarPhysicsSphereInterpolationDelay(
+	TEXT("MultiplayerCourse.PhysicsSphere.InterpolationDelay"),
+	0.15f,
+	TEXT("Seconds clients render spheres in the past. Should cover about two update intervals."));
+
+static TAutoConsoleVariable<float> CVarPhysicsSphereMaxExtrapolation(
+	TEXT("MultiplayerCourse.PhysicsSphere.MaxExtrapolation"),
+	0.25f,
+	TEXT("Seconds a sphere keeps moving on its last velocity when the next snapshot is late."));
+
+static TAutoConsoleVariable<bool> CVarPhysicsSphereReplicatedMovement(
+	TEXT("MultiplayerCourse.PhysicsSphere.ReplicatedMovement"),
+	false,
+	TEXT("Spheres that start simulating after this is set send the engine's replicated movement instead of FSpherePhysicsState.\n")
+	TEXT("Only for bandwidth comparisons, see MultiplayerCourse.SpherePool.Benchmark."));
+
+static constexpr int32 MaxSnapshots = 8;
+
+void FSpherePhysicsState::Quantize()
+{
+	Location = FVector(
+		FMath::RoundToDouble(Location.X * 10.0) / 10.0,
+		FMath::RoundToDouble(Location.Y * 10.0) / 10.0,
+		FMath::RoundToDouble(Location.Z * 10.0) / 10.0);
+
+	Rotation = FRotator(
+		FRotator::DecompressAxisFromShort(FRotator::CompressAxisToShort(Rotation.Pitch)),
+		FRotator::DecompressAxisFromShort(FRotator::CompressAxisToShort(Rotation.Yaw)),
+		FRotator::DecompressAxisFromShort(FRotator::CompressAxisToShort(Rotation.Roll)));
+
+	LinearVelocity = FVector(
+		FMath::RoundToDouble(LinearVelocity.X),
+		FMath::RoundToDouble(LinearVelocity.Y),
+		FMath::RoundToDouble(LinearVelocity.Z));
+
+	AngularVelocity = FVector(
+		FMath::RoundToDouble(AngularVelocity.X),
+		FMath::RoundToDouble(AngularVelocity.Y),
+		FMath::RoundToDouble(AngularVelocity.Z));
+}
+
+bool FSpherePhysicsState::operator==(const FSpherePhysicsState& Other) const
+{
+	return Location == Other.Location
+		&& Rotation == Other.Rotation
+		&& LinearVelocity == Other.LinearVelocity
+		&& AngularVelocity == Other.AngularVelocity
+		&& bSleeping == Other.bSleeping;
+}
+
+AReplicatedPhysicsSphere::AReplicatedPhysicsSphere()
+{
+	// Replication is switched on by USpherePoolSubsystem once the sphere is set up
+	SetReplicatingMovement(false);
+
+	// Only clients tick, and only while they have snapshots to play back
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+
+	UStaticMeshComponent* StaticMeshComponent = GetStaticMeshComponent();
+	StaticMeshComponent->Mobility = EComponentMobility::Movable;
+	StaticMeshComponent->SetIsReplicated(false);
+	StaticMeshComponent->SetSimulatePhysics(false);
+	StaticMeshComponent->BodyInstance.bGenerateWakeEvents = true;
+}
+
+void AReplicatedPhysicsSphere::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (HasAuthority())
+	{
+		GetStaticMeshComponent()->OnComponentWake.AddDynamic(this, &AReplicatedPhysicsSphere::OnBodyWake);
+		GetStaticMeshComponent()->OnComponentSleep.AddDynamic(this, &AReplicatedPhysicsSphere::OnBodySleep);
+	}
+}
+
+void AReplicatedPhysicsSphere::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AReplicatedPhysicsSphere, PhysicsState, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AReplicatedPhysicsSphere, SphereMesh, Params);
+}
+
+void AReplicatedPhysicsSphere::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	CapturePhysicsState();
+}
+
+void AReplicatedPhysicsSphere::CapturePhysicsState()
+{
+	if (IsReplicatingMovement())
+	{
+		return;
+	}
+
+	const UStaticMeshComponent* StaticMeshComponent = GetStaticMeshComponent();
+
+	FSpherePhysicsState NewState;
+	NewState.Location = GetActorLocation();
+	NewState.Rotation = GetActorRotation();
+	NewState.bSleeping = !StaticMeshComponent->IsSimulatingPhysics() || !StaticMeshComponent->RigidBodyIsAwake();
+	if (!NewState.bSleeping)
+	{
+		NewState.LinearVelocity = StaticMeshComponent->GetPhysicsLinearVelocity();
+		NewState.AngularVelocity = StaticMeshComponent->GetPhysicsAngularVelocityInDegrees();
+	}
+	NewState.Quantize();
+
+	if (NewState != PhysicsState)
+	{
+		PhysicsState = NewState;
+		PhysicsState.ServerTimeMs = (uint32)FMath::RoundToInt64(FMath::Max(GetServerTime(), 0.0) * 1000.0);
+		MARK_PROPERTY_DIRTY_FROM_NAME(AReplicatedPhysicsSphere, PhysicsState, this);
+		INC_DWORD_STAT(STAT_PhysicsSphereStateUpdates);
+	}
+}
+
+void AReplicatedPhysicsSphere::SetSphereMesh(UStaticMesh* Mesh)
+{
+	if (SphereMesh == Mesh)
+	{
+		return;
+	}
+
+	SphereMesh = Mesh;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AReplicatedPhysicsSphere, SphereMesh, this);
+	OnRep_SphereMesh();
+}
+
+void AReplicatedPhysicsSphere::StartSimulating(const FVector& Location)
+{
+	UStaticMeshComponent* StaticMeshComponent = GetStaticMeshComponent();
+	StaticMeshComponent->SetSimulatePhysics(false);
+
+	SetActorLocationAndRotation(Location, FRotator::ZeroRotator, false, nullptr, ETeleportType::ResetPhysics);
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+
+	StaticMeshComponent->SetSimulatePhysics(true);
+	StaticMeshComponent->SetPhysicsLinearVelocity(FVector::ZeroVector);
+	StaticMeshComponent->SetPhysicsAngularVelocityInDegrees(FVector::ZeroVector);
+
+	SetReplicateMovement(CVarPhysicsSphereReplicatedMovement.GetValueOnGameThread());
+	SetNetDormancy(DORM_Awake);
+
+	SimulatingSince = GetWorld()->GetTimeSeconds();
+}
+
+void AReplicatedPhysicsSphere::StopSimulating()
+{
+	GetStaticMeshComponent()->SetSimulatePhysics(false);
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+
+	// Send the hidden state once, then stay quiet until the sphere is reused
+	SetNetDormancy(DORM_DormantAll);
+	FlushNetDormancy();
+}
+
+void AReplicatedPhysicsSphere::OnBodyWake(UPrimitiveComponent* WakingComponent, FName BoneName)
+{
+	SetNetDormancy(DORM_Awake);
+}
+
+void AReplicatedPhysicsSphere::OnBodySleep(UPrimitiveComponent* SleepingComponent, FName BoneName)
+{
+	INC_DWORD_STAT(STAT_PhysicsSphereSleepEvents);
+
+	// The flush sends the resting state, after that a sleeping body sends nothing
+	CapturePhysicsState();
+	SetNetDormancy(DORM_DormantAll);
+	FlushNetDormancy();
+}
+
+void AReplicatedPhysicsSphere::OnRep_PhysicsState()
+{
+	// Without the game state there is no server clock to interpolate against yet
+	if (!CVarPhysicsSphereInterpolate.GetValueOnGameThread() || IsHidden() || GetServerTime() < 0.0)
+	{
+		Snapshots.Reset();
+		SetActorTickEnabled(false);
+		SetActorLocationAndRotation(PhysicsState.Location, PhysicsState.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+		return;
+	}
+
+	FSpherePhysicsSnapshot Snapshot;
+	Snapshot.ServerTime = PhysicsState.ServerTimeMs / 1000.0;
+	Snapshot.Location = PhysicsState.Location;
+	Snapshot.Rotation = PhysicsState.Rotation.Quaternion();
+	Snapshot.LinearVelocity = PhysicsState.LinearVelocity;
+	Snapshot.bSleeping = PhysicsState.bSleeping;
+
+	// Older than what is already buffered, e.g. reordered by the network
+	if (Snapshots.Num() > 0 && Snapshot.ServerTime <= Snapshots.Last().ServerTime)
+	{
+		return;
+	}
+
+	// A sphere coming out of the pool or waking after a long sleep has nothing sensible to blend from
+	if (Snapshots.Num() == 0 || Snapshot.ServerTime - Snapshots.Last().ServerTime > CVarPhysicsSphereInterpolationDelay.GetValueOnGameThread() + CVarPhysicsSphereMaxExtrapolation.GetValueOnGameThread())
+	{
+		Snapshots.Reset();
+		SetActorLocationAndRotation(Snapshot.Location, Snapshot.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+	}
+
+	if (Snapshots.Num() == MaxSnapshots)
+	{
+		Snapshots.RemoveAt(0, 1, false);
+	}
+	Snapshots.Add(Snapshot);
+
+	SetActorTickEnabled(true);
+}
+
+void AReplicatedPhysicsSphere::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	UpdateInterpolation(GetServerTime());
+}
+
+double AReplicatedPhysicsSphere::GetServerTime() const
+{
+	if (HasAuthority())
+	{
+		return GetWorld()->GetTimeSeconds();
+	}
+
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() : -1.0;
+}
+
+void AReplicatedPhysicsSphere::UpdateInterpolation(double ServerNow)
+{
+	if (Snapshots.Num() == 0)
+	{
+		SetActorTickEnabled(false);
+		return;
+	}
+
+	const double RenderTime = ServerNow - CVarPhysicsSphereInterpolationDelay.GetValueOnGameThread();
+
+	// Drop snapshots that are fully behind the render time, keeping one to blend from
+	int32 NumExpired = 0;
+	while (NumExpired + 1 < Snapshots.Num() && Snapshots[NumExpired + 1].ServerTime <= RenderTime)
+	{
+		++NumExpired;
+	}
+	if (NumExpired > 0)
+	{
+		Snapshots.RemoveAt(0, NumExpired, false);
+	}
+
+	const FSpherePhysicsSnapshot& From = Snapshots[0];
+
+	if (RenderTime <= From.ServerTime)
+	{
+		return;
+	}
+
+	if (Snapshots.Num() > 1)
+	{
+		const FSpherePhysicsSnapshot& To = Snapshots[1];
+		const double Span = To.ServerTime - From.ServerTime;
+		const float Alpha = Span > UE_SMALL_NUMBER ? (float)((RenderTime - From.ServerTime) / Span) : 1.0f;
+
+		// Hermite with the replicated velocities follows arcs between snapshots instead of cutting corners
+		const FVector Location = FMath::CubicInterp(From.Location, From.LinearVelocity * Span, To.Location, To.LinearVelocity * Span, Alpha);
+		const FQuat Rotation = FQuat::Slerp(From.Rotation, To.Rotation, Alpha);
+		SetActorLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+		return;
+	}
+
+	// Render time has passed the newest snapshot
+	if (From.bSleeping)
+	{
+		SetActorLocationAndRotation(From.Location, From.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+		Snapshots.Reset();
+		SetActorTickEnabled(false);
+		return;
+	}
+
+	const double ExtrapolationTime = FMath::Min(RenderTime - From.ServerTime, (double)CVarPhysicsSphereMaxExtrapolation.GetValueOnGameThread());
+	SetActorLocation(From.Location + From.LinearVelocity * ExtrapolationTime, false, nullptr, ETeleportType::TeleportPhysics);
+	INC_DWORD_STAT(STAT_PhysicsSphereExtrapolations);
+}
+
+void AReplicatedPhysicsSphere::OnRep_SphereMesh()
+{
+	GetStaticMeshComponent()->SetStaticMesh(SphereMesh);
+}
@@ -0,0 +1,125 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "Engine/StaticMeshActor.h"
+#include "ReplicatedPhysicsSphere.generated.h"
+
+/**
+ * Rigid-body state of a sphere, quantized to the precision it is sent with.
+ * Members are replicated individually, so an update only carries the fields
+ * that differ from the last state the client acknowledged.
+ */
+USTRUCT()
+struct FSpherePhysicsState
+{
+	GENERATED_BODY()
+
+	// 0.1 cm precision
+	UPROPERTY()
+	FVector_NetQuantize10 Location = FVector::ZeroVector;
+
+	// 16 bits per axis
+	UPROPERTY()
+	FRotator Rotation = FRotator::ZeroRotator;
+
+	// 1 cm/s precision
+	UPROPERTY()
+	FVector_NetQuantize LinearVelocity = FVector::ZeroVector;
+
+	// 1 deg/s precision
+	UPROPERTY()
+	FVector_NetQuantize AngularVelocity = FVector::ZeroVector;
+
+	UPROPERTY()
+	bool bSleeping = false;
+
+	// Server world time the state was sampled at, in milliseconds. Not part of the comparison,
+	// it only changes together with the physical state.
+	UPROPERTY()
+	uint32 ServerTimeMs = 0;
+
+	// Rounds every member the same way NetSerialize will, so changes too small to be sent compare equal
+	void Quantize();
+
+	bool operator==(const FSpherePhysicsState& Other) const;
+	bool operator!=(const FSpherePhysicsState& Other) const { return !(*this == Other); }
+};
+
+// A received FSpherePhysicsState on the server's clock
+struct FSpherePhysicsSnapshot
+{
+	double ServerTime = 0.0;
+	FVector Location = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	FVector LinearVelocity = FVector::ZeroVector;
+	bool bSleeping = false;
+};
+
+/**
+ * Physics sphere spawned through USpherePoolSubsystem.
+ * Replaces replicated movement with a quantized FSpherePhysicsState that is sampled
+ * only when the actor is about to replicate. The sphere goes dormant while its body
+ * sleeps, so resting spheres cost nothing until they are woken up.
+ * Clients buffer the received states and render slightly behind the estimated server time,
+ * interpolating between snapshots by the time they were sampled rather than the time they
+ * arrived, so motion stays smooth at a low NetUpdateFrequency and network jitter doesn't show.
+ */
+UCLASS()
+class MULTIPLAYERCOURSE_API AReplicatedPhysicsSphere : public AStaticMeshActor
+{
+	GENERATED_BODY()
+
+public:
+	AReplicatedPhysicsSphere();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+	virtual void Tick(float DeltaSeconds) override;
+
+	void SetSphereMesh(UStaticMesh* Mesh);
+
+	// Server only, called by USpherePoolSubsystem when the sphere is acquired or released
+	void StartSimulating(const FVector& Location);
+	void StopSimulating();
+
+	// Server world time of the last StartSimulating
+	double GetSimulatingSince() const { return SimulatingSince; }
+
+protected:
+	virtual void BeginPlay() override;
+
+	UFUNCTION()
+	void OnRep_PhysicsState();
+
+	UFUNCTION()
+	void OnRep_SphereMesh();
+
+	UFUNCTION()
+	void OnBodyWake(UPrimitiveComponent* WakingComponent, FName BoneName);
+
+	UFUNCTION()
+	void OnBodySleep(UPrimitiveComponent* SleepingComponent, FName BoneName);
+
+	// Samples the body and marks PhysicsState dirty if the quantized state changed
+	void CapturePhysicsState();
+
+	// Client: places the sphere where the snapshot buffer says it was at ServerNow - InterpolationDelay
+	void UpdateInterpolation(double ServerNow);
+
+	// Server world time, as estimated by the client off the game state, or -1 before it has arrived
+	double GetServerTime() const;
+
+	// Client only, oldest first
+	TArray<FSpherePhysicsSnapshot> Snapshots;
+
+	double SimulatingSince = 0.0;
+
+	UPROPERTY(ReplicatedUsing = OnRep_PhysicsState)
+	FSpherePhysicsState PhysicsState;
+
+	UPROPERTY(ReplicatedUsing = OnRep_SphereMesh)
+	TObjectPtr<UStaticMesh> SphereMesh;
+};
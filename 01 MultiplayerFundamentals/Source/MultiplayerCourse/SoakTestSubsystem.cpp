@@ -0,0 +1,134 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SoakTestSubsystem.h"
+#include "MultiplayerCourseCharacter.h"
+#include "MultiplayerCourseGameMode.h"
+#include "CosmeticEventSubsystem.h"
+#include "RPCRateLimitSubsystem.h"
+#include "SpherePoolSubsystem.h"
+#include "GameFramework/PlayerController.h"
+
+USoakTestSubsystem::USoakTestSubsystem()
+{
+	SpawnRequestsPerSecond = 20.0f;
+	ServerRPCsPerSecond = 20.0f;
+	bBotsBypassClientRateLimit = true;
+	CosmeticEventsPerSecond = 4.0f;
+
+	bHost = false;
+	CosmeticEventBudget = 0.0f;
+	SpawnRequestBudget = 0.0f;
+	ServerRPCBudget = 0.0f;
+	NumSpheresRequested = 0;
+	NumServerRPCsSent = 0;
+}
+
+void USoakTestSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	bHost = FParse::Param(FCommandLine::Get(), TEXT("SoakHost"));
+
+	Super::Initialize(Collection);
+}
+
+void USoakTestSubsystem::RequestSession(UWorld* World)
+{
+	AMultiplayerCourseGameMode* GameMode = World->GetAuthGameMode<AMultiplayerCourseGameMode>();
+	if (!GameMode)
+	{
+		return;
+	}
+
+	if (bHost)
+	{
+		GameMode->HostLANGame();
+	}
+	else
+	{
+		GameMode->JoinLANGame();
+	}
+}
+
+void USoakTestSubsystem::TickHost(UWorld* World, float DeltaTime)
+{
+	CosmeticEventBudget += DeltaTime * CosmeticEventsPerSecond;
+	if (CosmeticEventBudget >= 1.0f)
+	{
+		CosmeticEventBudget -= 1.0f;
+		for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+		{
+			if (AMultiplayerCourseCharacter* Character = It->Get() ? Cast<AMultiplayerCourseCharacter>(It->Get()->GetPawn()) : nullptr)
+			{
+				Character->ClientRPCFunction();
+			}
+		}
+	}
+}
+
+void USoakTestSubsystem::TickBotActions(ACharacter* Character, float DeltaTime)
+{
+	AMultiplayerCourseCharacter* CourseCharacter = Cast<AMultiplayerCourseCharacter>(Character);
+	if (!CourseCharacter)
+	{
+		return;
+	}
+
+	SpawnRequestBudget += DeltaTime * SpawnRequestsPerSecond;
+	const int32 NumSpawnRequests = FMath::Min((int32)SpawnRequestBudget, AMultiplayerCourseCharacter::MaxSpawnBatch);
+	SpawnRequestBudget -= NumSpawnRequests;
+	NumSpheresRequested += NumSpawnRequests;
+
+	if (bBotsBypassClientRateLimit && NumSpawnRequests > 0)
+	{
+		CourseCharacter->ServerRPCSpawnSpheres(FNetSpawnCount(NumSpawnRequests));
+	}
+	else
+	{
+		for (int32 Idx = 0; Idx < NumSpawnRequests; ++Idx)
+		{
+			CourseCharacter->RequestSpawnSphere();
+		}
+	}
+
+	ServerRPCBudget += DeltaTime * ServerRPCsPerSecond;
+	while (ServerRPCBudget >= 1.0f)
+	{
+		const int32 Percent = FMath::RandRange(0, FNetPercent::Max);
+		if (bBotsBypassClientRateLimit)
+		{
+			CourseCharacter->ServerRPCFunctionPacked(FNetPercent(Percent));
+		}
+		else
+		{
+			CourseCharacter->ServerRPCFunction(Percent);
+		}
+		ServerRPCBudget -= 1.0f;
+		++NumServerRPCsSent;
+	}
+}
+
+void USoakTestSubsystem::OnSoakFinished(UWorld* World)
+{
+	if (bHost)
+	{
+		return;
+	}
+
+	const URPCRateLimitSubsystem* RateLimiter = World->GetSubsystem<URPCRateLimitSubsystem>();
+	UE_LOG(LogTemp, Log, TEXT("Soak test: bot requested %d spheres and %d server RPCs, throttled %d before sending%s"),
+		NumSpheresRequested, NumServerRPCsSent, RateLimiter ? RateLimiter->GetNumDropped() : 0,
+		bBotsBypassClientRateLimit ? TEXT(" (client rate limit bypassed)") : TEXT(""));
+}
+
+void USoakTestSubsystem::AddReportFields(UWorld* World, TArray<FString>& OutFields) const
+{
+	const URPCRateLimitSubsystem* RateLimiter = World ? World->GetSubsystem<URPCRateLimitSubsystem>() : nullptr;
+	const USpherePoolSubsystem* SpherePool = World ? World->GetSubsystem<USpherePoolSubsystem>() : nullptr;
+	const UCosmeticEventSubsystem* CosmeticEvents = World ? World->GetSubsystem<UCosmeticEventSubsystem>() : nullptr;
+
+	OutFields.Add(FString::Printf(TEXT("\"droppedRPCs\": %d"), RateLimiter ? RateLimiter->GetNumDropped() : 0));
+	OutFields.Add(FString::Printf(TEXT("\"spherePool\": { \"hits\": %d, \"misses\": %d, \"evictions\": %d }"),
+		SpherePool ? SpherePool->GetNumHits() : 0, SpherePool ? SpherePool->GetNumMisses() : 0, SpherePool ? SpherePool->GetNumEvictions() : 0));
+	OutFields.Add(FString::Printf(TEXT("\"cosmeticEvents\": { \"sent\": %d, \"bundles\": %d, \"dropped\": %d }"),
+		CosmeticEvents ? CosmeticEvents->GetNumEventsSent() : 0, CosmeticEvents ? CosmeticEvents->GetNumBundlesSent() : 0, CosmeticEvents ? CosmeticEvents->GetNumEventsDropped() : 0));
+}
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SoakTestSubsystemBase.h"
+#include "SoakTestSubsystem.generated.h"
+
+/**
+ * MultiplayerCourse soak test, see USoakTestSubsystemBase. A host started with -SoakHost starts
+ * listening through HostLANGame and plays cosmetic events on every character, and also reports
+ * dropped RPCs, sphere pool churn and cosmetic event traffic. Bots join through JoinLANGame
+ * (see -JoinAddress) and spam sphere spawn and reliable server RPCs, by default straight through
+ * ServerRPCSpawnSpheres and ServerRPCFunctionPacked so the host's droppedRPCs counts server-side drops.
+ * The report is Saved/Profiling/Soak_MultiplayerCourse.json. See multiplayer_soak_test.sh.
+ */
+UCLASS(Config=Game)
+class MULTIPLAYERCOURSE_API USoakTestSubsystem : public USoakTestSubsystemBase
+{
+	GENERATED_BODY()
+
+public:
+	USoakTestSubsystem();
+
+	void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	// Sphere spawn requests a bot makes per second, above the rate limit on purpose
+	UPROPERTY(Config)
+	float SpawnRequestsPerSecond;
+
+	// Reliable ServerRPCFunction calls a bot makes per second, also above the rate limit
+	UPROPERTY(Config)
+	float ServerRPCsPerSecond;
+
+	// Bots call the server RPCs directly instead of through RequestSpawnSphere and ServerRPCFunction,
+	// skipping the client-side rate limit so the server's limit is what drops the excess
+	UPROPERTY(Config)
+	bool bBotsBypassClientRateLimit;
+
+	// Cosmetic events the host plays on each character per second
+	UPROPERTY(Config)
+	float CosmeticEventsPerSecond;
+
+protected:
+	virtual bool IsHost() const override { return bHost; }
+	virtual void RequestSession(UWorld* World) override;
+	virtual void TickHost(UWorld* World, float DeltaTime) override;
+	virtual void TickBotActions(ACharacter* Character, float DeltaTime) override;
+	virtual void OnSoakFinished(UWorld* World) override;
+	virtual void AddReportFields(UWorld* World, TArray<FString>& OutFields) const override;
+	virtual FString GetReportFileName() const override { return TEXT("Soak_MultiplayerCourse.json"); }
+
+private:
+	bool bHost;
+	float CosmeticEventBudget;
+
+	// Bot state
+	float SpawnRequestBudget;
+	float ServerRPCBudget;
+	int32 NumSpheresRequested;
+	int32 NumServerRPCsSent;
+};
@@ -0,0 +1,327 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SpherePoolSubsystem.h"
+#include "MultiplayerCourse.h"
+#include "Engine/StaticMesh.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "NetRelevancyPolicyComponent.h"
+#include "ReplicatedPhysicsSphere.h"
+#include "SoakReport.h"
+#include "Engine/NetDriver.h"
+#include "HAL/IConsoleManager.h"
+#include "TimerManager.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Sphere Pool Hits"), STAT_SpherePoolHits, STATGROUP_MultiplayerCourse);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Sphere Pool Misses"), STAT_SpherePoolMisses, STATGROUP_MultiplayerCourse);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Sphere Pool Evictions"), STAT_SpherePoolEvictions, STATGROUP_MultiplayerCourse);
+
+static TAutoConsoleVariable<int32> CVarSpherePoolMaxSize(
+	TEXT("MultiplayerCourse.SpherePool.MaxSize"),
+	64,
+	TEXT("Maximum number of spheres alive at once. Beyond this the oldest sphere is recycled."));
+
+static TAutoConsoleVariable<float> CVarSpherePoolLifetime(
+	TEXT("MultiplayerCourse.SpherePool.Lifetime"),
+	10.0f,
+	TEXT("Seconds a sphere stays out before it is released back to the pool. 0 keeps spheres until they are evicted."));
+
+static TAutoConsoleVariable<float> CVarSpherePoolNetCullDistance(
+	TEXT("MultiplayerCourse.SpherePool.NetCullDistance"),
+	5000.0f,
+	TEXT("Distance beyond which pooled spheres stop replicating to a player. Applied when a sphere is spawned."));
+
+static TAutoConsoleVariable<float> CVarSpherePoolNetUpdateFrequency(
+	TEXT("MultiplayerCourse.SpherePool.NetUpdateFrequency"),
+	15.0f,
+	TEXT("Replication rate for pooled spheres. Applied when a sphere is spawned. Clients interpolate between updates, see MultiplayerCourse.PhysicsSphere.InterpolationDelay."));
+
+// Drops Count spheres in a square above the first player
+static void DropTestSpheres(UWorld* World, USpherePoolSubsystem* SpherePool, int32 Count)
+{
+	UStaticMesh* Mesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Sphere.Sphere"));
+	if (!Mesh)
+	{
+		return;
+	}
+
+	const int32 RowLength = FMath::Max(FMath::CeilToInt(FMath::Sqrt((float)Count)), 1);
+
+	const APlayerController* PlayerController = World->GetFirstPlayerController();
+	const FVector Origin = PlayerController && PlayerController->GetPawn() ? PlayerController->GetPawn()->GetActorLocation() : FVector::ZeroVector;
+
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		const FVector Offset((Index % RowLength) * 120.0f, (Index / RowLength) * 120.0f, 500.0f);
+		SpherePool->AcquireSphere(Mesh, Origin + Offset, nullptr);
+	}
+}
+
+// Load for measuring sphere replication bandwidth with 'stat net' and 'stat MultiplayerCourse'
+static FAutoConsoleCommandWithWorldAndArgs SpawnTestSpheresCommand(
+	TEXT("MultiplayerCourse.SpherePool.SpawnTestSpheres"),
+	TEXT("Drops <Count> simulating spheres above the first player. Server only, capped by MultiplayerCourse.SpherePool.MaxSize."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World || World->GetNetMode() == NM_Client)
+		{
+			return;
+		}
+
+		USpherePoolSubsystem* SpherePool = World->GetSubsystem<USpherePoolSubsystem>();
+		if (!SpherePool)
+		{
+			return;
+		}
+
+		const int32 Count = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 100;
+		DropTestSpheres(World, SpherePool, Count);
+
+		UE_LOG(LogTemp, Log, TEXT("Spawned %d test spheres (%d hits, %d misses, %d evictions so far)"),
+			Count, SpherePool->GetNumHits(), SpherePool->GetNumMisses(), SpherePool->GetNumEvictions());
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs SpherePoolBenchmarkCommand(
+	TEXT("MultiplayerCourse.SpherePool.Benchmark"),
+	TEXT("Drops <Count> spheres sending FSpherePhysicsState, then the same with replicated movement, and logs the average outgoing bytes/s over <Seconds> for each.\n")
+	TEXT("Defaults to 500 5. Run on a host with clients connected."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		USpherePoolSubsystem* SpherePool = World && World->GetNetMode() != NM_Client ? World->GetSubsystem<USpherePoolSubsystem>() : nullptr;
+		if (!SpherePool)
+		{
+			return;
+		}
+
+		const int32 Count = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 500;
+		const float Seconds = Args.Num() > 1 ? FMath::Max(FCString::Atof(*Args[1]), 1.0f) : 5.0f;
+		SpherePool->StartBandwidthBenchmark(Count, Seconds);
+	}));
+
+bool USpherePoolSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void USpherePoolSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (InWorld.GetNetMode() != NM_Client)
+	{
+		InWorld.GetTimerManager().SetTimer(ExpiryTimer, this, &USpherePoolSubsystem::ReleaseExpiredSpheres, 1.0f, true);
+	}
+}
+
+AReplicatedPhysicsSphere* USpherePoolSubsystem::AcquireSphere(UStaticMesh* Mesh, const FVector& Location, AActor* Owner)
+{
+	// Spheres can still be destroyed behind the pool's back, e.g. by falling below KillZ
+	ActiveSpheres.RemoveAll([](const TObjectPtr<AReplicatedPhysicsSphere>& Active) { return !IsValid(Active); });
+
+	AReplicatedPhysicsSphere* Sphere = nullptr;
+
+	while (!Sphere && FreeSpheres.Num() > 0)
+	{
+		AReplicatedPhysicsSphere* Candidate = FreeSpheres.Pop(false);
+		if (IsValid(Candidate))
+		{
+			Sphere = Candidate;
+		}
+	}
+
+	if (Sphere)
+	{
+		++NumHits;
+		INC_DWORD_STAT(STAT_SpherePoolHits);
+	}
+	else if (ActiveSpheres.Num() < FMath::Max(CVarSpherePoolMaxSize.GetValueOnGameThread(), 1))
+	{
+		Sphere = SpawnSphere(Mesh, Owner);
+		if (!Sphere)
+		{
+			return nullptr;
+		}
+
+		++NumMisses;
+		INC_DWORD_STAT(STAT_SpherePoolMisses);
+	}
+	else
+	{
+		Sphere = ActiveSpheres[0];
+		ActiveSpheres.RemoveAt(0, 1, false);
+
+		++NumEvictions;
+		INC_DWORD_STAT(STAT_SpherePoolEvictions);
+	}
+
+	Sphere->SetSphereMesh(Mesh);
+	Sphere->SetOwner(Owner);
+	Sphere->StartSimulating(Location);
+
+	ActiveSpheres.Add(Sphere);
+	return Sphere;
+}
+
+void USpherePoolSubsystem::ReleaseSphere(AReplicatedPhysicsSphere* Sphere)
+{
+	if (!Sphere || ActiveSpheres.Remove(Sphere) == 0)
+	{
+		return;
+	}
+
+	Sphere->StopSimulating();
+
+	FreeSpheres.Add(Sphere);
+}
+
+void USpherePoolSubsystem::ReleaseExpiredSpheres()
+{
+	const float Lifetime = CVarSpherePoolLifetime.GetValueOnGameThread();
+	if (Lifetime <= 0.0f)
+	{
+		return;
+	}
+
+	ActiveSpheres.RemoveAll([](const TObjectPtr<AReplicatedPhysicsSphere>& Active) { return !IsValid(Active); });
+
+	// Oldest first, so everything that expired is at the front
+	const double Now = GetWorld()->GetTimeSeconds();
+	int32 NumExpired = 0;
+	while (NumExpired < ActiveSpheres.Num() && Now - ActiveSpheres[NumExpired]->GetSimulatingSince() >= Lifetime)
+	{
+		AReplicatedPhysicsSphere* Sphere = ActiveSpheres[NumExpired++];
+		Sphere->StopSimulating();
+		FreeSpheres.Add(Sphere);
+	}
+
+	ActiveSpheres.RemoveAt(0, NumExpired, false);
+}
+
+void USpherePoolSubsystem::ReleaseAllSpheres()
+{
+	for (AReplicatedPhysicsSphere* Sphere : ActiveSpheres)
+	{
+		if (IsValid(Sphere))
+		{
+			Sphere->StopSimulating();
+			FreeSpheres.Add(Sphere);
+		}
+	}
+	ActiveSpheres.Reset();
+}
+
+void USpherePoolSubsystem::StartBandwidthBenchmark(int32 Count, float Seconds)
+{
+	UWorld* World = GetWorld();
+	if (World->GetTimerManager().IsTimerActive(BenchmarkTimer))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Sphere benchmark is already running"));
+		return;
+	}
+
+	const UNetDriver* NetDriver = World->GetNetDriver();
+	if (!NetDriver || NetDriver->ClientConnections.Num() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Sphere benchmark needs a host with clients connected, nothing is replicated otherwise"));
+		return;
+	}
+
+	// Every sphere has to stay out for the whole run
+	PreviousMaxSize = CVarSpherePoolMaxSize.GetValueOnGameThread();
+	PreviousLifetime = CVarSpherePoolLifetime.GetValueOnGameThread();
+	CVarSpherePoolMaxSize->Set(FMath::Max(PreviousMaxSize, Count), ECVF_SetByConsole);
+	CVarSpherePoolLifetime->Set(0.0f, ECVF_SetByConsole);
+
+	BenchmarkCount = Count;
+	BenchmarkSeconds = FMath::CeilToInt(Seconds);
+	bBenchmarkReplicatedMovement = false;
+	DropBenchmarkSpheres();
+
+	World->GetTimerManager().SetTimer(BenchmarkTimer, this, &USpherePoolSubsystem::SampleBandwidthBenchmark, 1.0f, true);
+}
+
+void USpherePoolSubsystem::DropBenchmarkSpheres()
+{
+	ReleaseAllSpheres();
+
+	// Read by each sphere as it starts simulating
+	if (IConsoleVariable* ReplicatedMovement = IConsoleManager::Get().FindConsoleVariable(TEXT("MultiplayerCourse.PhysicsSphere.ReplicatedMovement")))
+	{
+		ReplicatedMovement->Set(bBenchmarkReplicatedMovement, ECVF_SetByConsole);
+	}
+
+	DropTestSpheres(GetWorld(), this, BenchmarkCount);
+	BenchmarkOutBytesPerSecond.Reset();
+}
+
+void USpherePoolSubsystem::SampleBandwidthBenchmark()
+{
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	if (!NetDriver)
+	{
+		FinishBandwidthBenchmark();
+		return;
+	}
+
+	BenchmarkOutBytesPerSecond.Add(NetDriver->OutBytesPerSecond);
+
+	// The first second still carries the previous batch being hidden
+	if (BenchmarkOutBytesPerSecond.Num() <= BenchmarkSeconds)
+	{
+		return;
+	}
+
+	BenchmarkOutBytesPerSecond.RemoveAt(0);
+	UE_LOG(LogTemp, Log, TEXT("Sphere benchmark, %d spheres, %d connections, %s: %.0f bytes/s out on average over %d s"),
+		ActiveSpheres.Num(), NetDriver->ClientConnections.Num(),
+		bBenchmarkReplicatedMovement ? TEXT("replicated movement") : TEXT("FSpherePhysicsState"),
+		SoakReport::Average(BenchmarkOutBytesPerSecond), BenchmarkOutBytesPerSecond.Num());
+
+	if (!bBenchmarkReplicatedMovement)
+	{
+		bBenchmarkReplicatedMovement = true;
+		DropBenchmarkSpheres();
+		return;
+	}
+
+	FinishBandwidthBenchmark();
+}
+
+void USpherePoolSubsystem::FinishBandwidthBenchmark()
+{
+	GetWorld()->GetTimerManager().ClearTimer(BenchmarkTimer);
+	ReleaseAllSpheres();
+
+	bBenchmarkReplicatedMovement = false;
+	if (IConsoleVariable* ReplicatedMovement = IConsoleManager::Get().FindConsoleVariable(TEXT("MultiplayerCourse.PhysicsSphere.ReplicatedMovement")))
+	{
+		ReplicatedMovement->Set(false, ECVF_SetByConsole);
+	}
+	CVarSpherePoolMaxSize->Set(PreviousMaxSize, ECVF_SetByConsole);
+	CVarSpherePoolLifetime->Set(PreviousLifetime, ECVF_SetByConsole);
+}
+
+AReplicatedPhysicsSphere* USpherePoolSubsystem::SpawnSphere(UStaticMesh* Mesh, AActor* Owner)
+{
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.Owner = Owner;
+	AReplicatedPhysicsSphere *Sphere = GetWorld()->SpawnActor<AReplicatedPhysicsSphere>(SpawnParameters);
+	if (!Sphere)
+	{
+		return nullptr;
+	}
+
+	// Added before SetReplicates so the replication graph sees it when the sphere is routed
+	UNetRelevancyPolicyComponent* NetRelevancyPolicy = NewObject<UNetRelevancyPolicyComponent>(Sphere);
+	NetRelevancyPolicy->NetCullDistance = CVarSpherePoolNetCullDistance.GetValueOnGameThread();
+	NetRelevancyPolicy->NetUpdateFrequency = CVarSpherePoolNetUpdateFrequency.GetValueOnGameThread();
+	NetRelevancyPolicy->MinNetUpdateFrequency = 2.0f;
+	NetRelevancyPolicy->RegisterComponent();
+
+	Sphere->SetSphereMesh(Mesh);
+	Sphere->SetReplicates(true);
+
+	return Sphere;
+}
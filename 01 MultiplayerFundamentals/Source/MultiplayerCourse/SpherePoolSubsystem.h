@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SpherePoolSubsystem.generated.h"
+
+class AReplicatedPhysicsSphere;
+class UStaticMesh;
+
+/**
+ * Server-side pool of replicated physics spheres.
+ * Spheres are never destroyed, so their actor channels stay open and are reused.
+ * A sphere is released back to the pool once it has been out for
+ * MultiplayerCourse.SpherePool.Lifetime seconds; if the pool is full before that,
+ * the oldest active sphere is recycled.
+ */
+UCLASS()
+class MULTIPLAYERCOURSE_API USpherePoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	// Returns a simulating sphere at Location, spawning, reusing or evicting as needed
+	AReplicatedPhysicsSphere* AcquireSphere(UStaticMesh* Mesh, const FVector& Location, AActor* Owner);
+
+	// Hides the sphere and makes it available to the next AcquireSphere
+	void ReleaseSphere(AReplicatedPhysicsSphere* Sphere);
+
+	int32 GetNumHits() const { return NumHits; }
+	int32 GetNumMisses() const { return NumMisses; }
+	int32 GetNumEvictions() const { return NumEvictions; }
+
+	// Drops Count spheres with FSpherePhysicsState and then with replicated movement,
+	// logging the server's average outgoing bytes/s over Seconds for each
+	void StartBandwidthBenchmark(int32 Count, float Seconds);
+
+private:
+	AReplicatedPhysicsSphere* SpawnSphere(UStaticMesh* Mesh, AActor* Owner);
+	void ReleaseExpiredSpheres();
+	void ReleaseAllSpheres();
+
+	void DropBenchmarkSpheres();
+	void SampleBandwidthBenchmark();
+	void FinishBandwidthBenchmark();
+
+	FTimerHandle ExpiryTimer;
+
+	FTimerHandle BenchmarkTimer;
+	int32 BenchmarkCount = 0;
+	int32 BenchmarkSeconds = 0;
+	bool bBenchmarkReplicatedMovement = false;
+	TArray<uint32> BenchmarkOutBytesPerSecond;
+	int32 PreviousMaxSize = 0;
+	float PreviousLifetime = 0.0f;
+
+	// Oldest first
+	UPROPERTY()
+	TArray<TObjectPtr<AReplicatedPhysicsSphere>> ActiveSpheres;
+
+	UPROPERTY()
+	TArray<TObjectPtr<AReplicatedPhysicsSphere>> FreeSpheres;
+
+	int32 NumHits = 0;
+	int32 NumMisses = 0;
+	int32 NumEvictions = 0;
+};
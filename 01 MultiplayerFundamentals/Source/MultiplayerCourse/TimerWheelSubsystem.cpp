@@ -0,0 +1,358 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TimerWheelSubsystem.h"
+#include "MultiplayerCourse.h"
+#include "TimerManager.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Timer Wheel Tick"), STAT_TimerWheelTick, STATGROUP_MultiplayerCourse);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Timer Wheel Timers Fired"), STAT_TimerWheelFired, STATGROUP_MultiplayerCourse);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Timer Wheel Active Timers"), STAT_TimerWheelActive, STATGROUP_MultiplayerCourse);
+
+FTimerWheel::FTimerWheel()
+{
+	for (int32& Head : SlotHeads)
+	{
+		Head = INDEX_NONE;
+	}
+}
+
+int32 FTimerWheel::ToTicks(float Seconds)
+{
+	return FMath::Max(FMath::CeilToInt(Seconds / SlotDuration), 1);
+}
+
+const FTimerWheel::FTimer* FTimerWheel::FindTimer(const FWheelTimerHandle& Handle) const
+{
+	if (!Timers.IsValidIndex(Handle.Index))
+	{
+		return nullptr;
+	}
+
+	const FTimer& Timer = Timers[Handle.Index];
+	return Timer.bActive && Timer.Serial == Handle.Serial ? &Timer : nullptr;
+}
+
+void FTimerWheel::SetTimer(FWheelTimerHandle& InOutHandle, const FTimerDelegate& Delegate, float Rate, bool bLoop, float FirstDelay)
+{
+	ClearTimer(InOutHandle);
+
+	if (Rate <= 0.0f)
+	{
+		return;
+	}
+
+	int32 Index;
+	if (FreeIndices.Num() > 0)
+	{
+		Index = FreeIndices.Pop(false);
+	}
+	else
+	{
+		Index = Timers.AddDefaulted();
+	}
+
+	FTimer& Timer = Timers[Index];
+	Timer.Delegate = Delegate;
+	Timer.RateTicks = ToTicks(Rate);
+	Timer.bLoop = bLoop;
+	Timer.bActive = true;
+	Timer.Serial = NextSerial++;
+
+	// Counted from the current time rather than the start of the current slot, so a timer never
+	// fires early; the small bias keeps a delay of exactly N slots from rounding up to N + 1
+	const double Delay = FirstDelay >= 0.0f ? FirstDelay : Rate;
+	Timer.ExpireTick = FMath::Max(FMath::CeilToInt64((CurrentTime + Delay) / SlotDuration - UE_KINDA_SMALL_NUMBER), CurrentTick + 1);
+	Insert(Index);
+	++NumActiveTimers;
+
+	InOutHandle.Index = Index;
+	InOutHandle.Serial = Timer.Serial;
+}
+
+void FTimerWheel::ClearTimer(FWheelTimerHandle& InOutHandle)
+{
+	if (FindTimer(InOutHandle))
+	{
+		Unlink(InOutHandle.Index);
+		Free(InOutHandle.Index);
+	}
+	InOutHandle.Invalidate();
+}
+
+bool FTimerWheel::IsTimerActive(const FWheelTimerHandle& Handle) const
+{
+	return FindTimer(Handle) != nullptr;
+}
+
+float FTimerWheel::GetTimerRemaining(const FWheelTimerHandle& Handle) const
+{
+	const FTimer* Timer = FindTimer(Handle);
+	return Timer ? (float)FMath::Max(Timer->ExpireTick * SlotDuration - CurrentTime, 0.0) : -1.0f;
+}
+
+void FTimerWheel::Insert(int32 Index, int64 MinDelay)
+{
+	FTimer& Timer = Timers[Index];
+
+	// Anything already due goes in the next slot, anything past the top level's range waits at its far end
+	const int64 Delay = FMath::Clamp(Timer.ExpireTick - CurrentTick, MinDelay, MaxDelayTicks);
+	const int64 FileTick = CurrentTick + Delay;
+
+	int32 Level = 0;
+	while (Delay >= (int64(1) << (LevelBits * (Level + 1))))
+	{
+		++Level;
+	}
+
+	const int32 Slot = Level * SlotsPerLevel + (int32)((FileTick >> (LevelBits * Level)) & (SlotsPerLevel - 1));
+	Timer.Slot = Slot;
+	Timer.Prev = INDEX_NONE;
+	Timer.Next = SlotHeads[Slot];
+	if (Timer.Next != INDEX_NONE)
+	{
+		Timers[Timer.Next].Prev = Index;
+	}
+	SlotHeads[Slot] = Index;
+}
+
+void FTimerWheel::Unlink(int32 Index)
+{
+	FTimer& Timer = Timers[Index];
+	if (Timer.Slot == INDEX_NONE)
+	{
+		return;
+	}
+
+	if (Timer.Prev != INDEX_NONE)
+	{
+		Timers[Timer.Prev].Next = Timer.Next;
+	}
+	else
+	{
+		SlotHeads[Timer.Slot] = Timer.Next;
+	}
+
+	if (Timer.Next != INDEX_NONE)
+	{
+		Timers[Timer.Next].Prev = Timer.Prev;
+	}
+
+	Timer.Slot = INDEX_NONE;
+	Timer.Prev = INDEX_NONE;
+	Timer.Next = INDEX_NONE;
+}
+
+void FTimerWheel::Free(int32 Index)
+{
+	FTimer& Timer = Timers[Index];
+	Timer.Delegate.Unbind();
+	Timer.bActive = false;
+	FreeIndices.Add(Index);
+	--NumActiveTimers;
+}
+
+void FTimerWheel::Cascade(int32 Level, int32 SlotInLevel)
+{
+	const int32 Slot = Level * SlotsPerLevel + SlotInLevel;
+	int32 Index = SlotHeads[Slot];
+	SlotHeads[Slot] = INDEX_NONE;
+
+	while (Index != INDEX_NONE)
+	{
+		const int32 Next = Timers[Index].Next;
+		Insert(Index, 0);
+		Index = Next;
+	}
+}
+
+void FTimerWheel::CollectExpired(int32 SlotInLevel)
+{
+	int32 Index = SlotHeads[SlotInLevel];
+	SlotHeads[SlotInLevel] = INDEX_NONE;
+
+	while (Index != INDEX_NONE)
+	{
+		FTimer& Timer = Timers[Index];
+		const int32 Next = Timer.Next;
+		Timer.Slot = INDEX_NONE;
+		Timer.Prev = INDEX_NONE;
+		Timer.Next = INDEX_NONE;
+
+		if (Timer.ExpireTick > CurrentTick)
+		{
+			// Was clamped to the top level's range, still has time to wait
+			Insert(Index);
+		}
+		else
+		{
+			FWheelTimerHandle& Handle = Expired.AddDefaulted_GetRef();
+			Handle.Index = Index;
+			Handle.Serial = Timer.Serial;
+		}
+		Index = Next;
+	}
+}
+
+int32 FTimerWheel::Advance(double DeltaTime)
+{
+	CurrentTime += DeltaTime;
+	const int64 TargetTick = FMath::FloorToInt64(CurrentTime / SlotDuration);
+
+	while (CurrentTick < TargetTick)
+	{
+		++CurrentTick;
+
+		// Upper levels move down as the levels below them wrap, highest first
+		for (int32 Level = NumLevels - 1; Level > 0; --Level)
+		{
+			if ((CurrentTick & ((int64(1) << (LevelBits * Level)) - 1)) == 0)
+			{
+				Cascade(Level, (int32)((CurrentTick >> (LevelBits * Level)) & (SlotsPerLevel - 1)));
+			}
+		}
+
+		CollectExpired((int32)(CurrentTick & (SlotsPerLevel - 1)));
+	}
+
+	// Fire everything that came due in one pass. A callback may clear or set timers, including
+	// ones later in the batch, so each handle is checked again before it fires.
+	int32 NumFired = 0;
+	for (int32 ExpiredIdx = 0; ExpiredIdx < Expired.Num(); ++ExpiredIdx)
+	{
+		const FWheelTimerHandle Handle = Expired[ExpiredIdx];
+		if (!FindTimer(Handle))
+		{
+			continue;
+		}
+
+		FTimer& Timer = Timers[Handle.Index];
+		const FTimerDelegate Delegate = Timer.Delegate;
+		if (Timer.bLoop && Delegate.IsBound())
+		{
+			// After a hitch a looping timer fires once and picks up from the next slot
+			Timer.ExpireTick = FMath::Max(Timer.ExpireTick + Timer.RateTicks, CurrentTick + 1);
+			Insert(Handle.Index);
+		}
+		else
+		{
+			Free(Handle.Index);
+		}
+
+		Delegate.ExecuteIfBound();
+		++NumFired;
+	}
+	Expired.Reset();
+
+	return NumFired;
+}
+
+bool UTimerWheelSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && Super::ShouldCreateSubsystem(Outer);
+}
+
+bool UTimerWheelSubsystem::IsTickable() const
+{
+	return Wheel.GetNumActiveTimers() > 0;
+}
+
+TStatId UTimerWheelSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTimerWheelSubsystem, STATGROUP_Tickables);
+}
+
+void UTimerWheelSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TimerWheelTick);
+
+	const int32 NumFired = Wheel.Advance(DeltaTime);
+
+	INC_DWORD_STAT_BY(STAT_TimerWheelFired, NumFired);
+	SET_DWORD_STAT(STAT_TimerWheelActive, Wheel.GetNumActiveTimers());
+}
+
+static void RunTimerBenchmark(int32 NumTimers)
+{
+	// Same delays for both, one-shot timers between half a second and 30 seconds
+	FRandomStream Random(NumTimers);
+	TArray<float> Delays;
+	Delays.SetNumUninitialized(NumTimers);
+	for (float& Delay : Delays)
+	{
+		Delay = Random.FRandRange(0.5f, 30.0f);
+	}
+
+	int32 NumFired = 0;
+	const FTimerDelegate Delegate = FTimerDelegate::CreateLambda([&NumFired]() { ++NumFired; });
+
+	// FTimerManager only ticks once per frame, so expiry is measured as one 31 second step for both
+	double StartTime = FPlatformTime::Seconds();
+	FTimerManager TimerManager;
+	TArray<FTimerHandle> ManagerHandles;
+	ManagerHandles.SetNum(NumTimers);
+	for (int32 Index = 0; Index < NumTimers; ++Index)
+	{
+		TimerManager.SetTimer(ManagerHandles[Index], Delegate, Delays[Index], false);
+	}
+	const double ManagerSetMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	StartTime = FPlatformTime::Seconds();
+	for (int32 Index = 0; Index < NumTimers; Index += 2)
+	{
+		TimerManager.ClearTimer(ManagerHandles[Index]);
+	}
+	const double ManagerClearMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	StartTime = FPlatformTime::Seconds();
+	TimerManager.Tick(31.0f);
+	const double ManagerFireMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	const int32 ManagerFired = NumFired;
+
+	NumFired = 0;
+	StartTime = FPlatformTime::Seconds();
+	FTimerWheel Wheel;
+	TArray<FWheelTimerHandle> WheelHandles;
+	WheelHandles.SetNum(NumTimers);
+	for (int32 Index = 0; Index < NumTimers; ++Index)
+	{
+		Wheel.SetTimer(WheelHandles[Index], Delegate, Delays[Index], false);
+	}
+	const double WheelSetMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	StartTime = FPlatformTime::Seconds();
+	for (int32 Index = 0; Index < NumTimers; Index += 2)
+	{
+		Wheel.ClearTimer(WheelHandles[Index]);
+	}
+	const double WheelClearMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	StartTime = FPlatformTime::Seconds();
+	Wheel.Advance(31.0);
+	const double WheelFireMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	UE_LOG(LogTemp, Log, TEXT("Timer benchmark, %d timers: FTimerManager set %.2f ms, clear half %.2f ms, fire %d in %.2f ms"),
+		NumTimers, ManagerSetMs, ManagerClearMs, ManagerFired, ManagerFireMs);
+	UE_LOG(LogTemp, Log, TEXT("Timer benchmark, %d timers: FTimerWheel set %.2f ms, clear half %.2f ms, fire %d in %.2f ms"),
+		NumTimers, WheelSetMs, WheelClearMs, NumFired, WheelFireMs);
+}
+
+static FAutoConsoleCommand TimerWheelBenchmarkCommand(
+	TEXT("MultiplayerCourse.TimerWheel.Benchmark"),
+	TEXT("Times setting, clearing and firing one-shot timers in FTimerManager and FTimerWheel. Takes timer counts, defaults to 10000 100000."),
+	FConsoleCommandWithArgsDelegate::CreateStatic([](const TArray<FString>& Args)
+	{
+		if (Args.Num() == 0)
+		{
+			RunTimerBenchmark(10000);
+			RunTimerBenchmark(100000);
+			return;
+		}
+
+		for (const FString& Arg : Args)
+		{
+			RunTimerBenchmark(FMath::Max(FCString::Atoi(*Arg), 1));
+		}
+	}));
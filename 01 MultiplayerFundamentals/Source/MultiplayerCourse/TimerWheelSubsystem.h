@@ -0,0 +1,137 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TimerWheelSubsystem.generated.h"
+
+// Identifies a timer in an FTimerWheel, used like FTimerHandle
+struct FWheelTimerHandle
+{
+	bool IsValid() const { return Index != INDEX_NONE; }
+	void Invalidate() { Index = INDEX_NONE; Serial = 0; }
+
+	bool operator==(const FWheelTimerHandle& Other) const { return Index == Other.Index && Serial == Other.Serial; }
+
+private:
+	friend class FTimerWheel;
+
+	int32 Index = INDEX_NONE;
+	uint32 Serial = 0;
+};
+
+/**
+ * Hierarchical timing wheel. Time advances in fixed slots of SlotDuration seconds; a timer
+ * lives in a slot of the lowest level whose range covers its delay and moves down a level
+ * each time the level above wraps, so setting and clearing a timer is O(1) and each frame
+ * only touches the slots that have come due. Everything that expires in one Advance is
+ * fired together at the end of it.
+ */
+class MULTIPLAYERCOURSE_API FTimerWheel
+{
+public:
+	static constexpr double SlotDuration = 1.0 / 60.0;
+
+	FTimerWheel();
+
+	// Same rules as FTimerManager::SetTimer: Rate <= 0 clears the timer, a valid handle is reset
+	void SetTimer(FWheelTimerHandle& InOutHandle, const FTimerDelegate& Delegate, float Rate, bool bLoop, float FirstDelay = -1.0f);
+	void ClearTimer(FWheelTimerHandle& InOutHandle);
+
+	bool IsTimerActive(const FWheelTimerHandle& Handle) const;
+
+	// Seconds until the timer fires, -1 if it isn't active
+	float GetTimerRemaining(const FWheelTimerHandle& Handle) const;
+
+	// Moves time forward and fires every timer that came due, returns how many fired
+	int32 Advance(double DeltaTime);
+
+	int32 GetNumActiveTimers() const { return NumActiveTimers; }
+
+private:
+	static constexpr int32 LevelBits = 6;
+	static constexpr int32 SlotsPerLevel = 1 << LevelBits;
+	static constexpr int32 NumLevels = 4;
+
+	// Delays longer than this wait in the top level and are re-filed when it wraps
+	static constexpr int64 MaxDelayTicks = (int64(1) << (LevelBits * NumLevels)) - 1;
+
+	struct FTimer
+	{
+		FTimerDelegate Delegate;
+		int64 ExpireTick = 0;
+		int32 RateTicks = 0;
+		bool bLoop = false;
+		bool bActive = false;
+		uint32 Serial = 0;
+
+		// Intrusive list of the slot the timer is filed in, Slot is INDEX_NONE while it waits to fire
+		int32 Slot = INDEX_NONE;
+		int32 Prev = INDEX_NONE;
+		int32 Next = INDEX_NONE;
+	};
+
+	const FTimer* FindTimer(const FWheelTimerHandle& Handle) const;
+
+	// MinDelay is 0 only while cascading, when the current slot hasn't been collected yet
+	void Insert(int32 Index, int64 MinDelay = 1);
+	void Unlink(int32 Index);
+	void Free(int32 Index);
+
+	// Re-files every timer in a slot of an upper level, they all land in lower levels
+	void Cascade(int32 Level, int32 SlotInLevel);
+
+	// Moves the due level 0 slot into Expired
+	void CollectExpired(int32 SlotInLevel);
+
+	static int32 ToTicks(float Seconds);
+
+	TArray<FTimer> Timers;
+	TArray<int32> FreeIndices;
+	int32 SlotHeads[NumLevels * SlotsPerLevel];
+
+	// Timers that came due during the current Advance, fired once it has caught up
+	TArray<FWheelTimerHandle> Expired;
+
+	int64 CurrentTick = 0;
+	double CurrentTime = 0.0;
+	int32 NumActiveTimers = 0;
+	uint32 NextSerial = 1;
+};
+
+/**
+ * World timer wheel for gameplay timers that exist in large numbers, e.g. per-actor puzzle timers.
+ * Takes the same calls as the world's FTimerManager. Timers are rounded up to the next
+ * FTimerWheel::SlotDuration and are not cleared automatically when their object ends play.
+ */
+UCLASS()
+class MULTIPLAYERCOURSE_API UTimerWheelSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	template<class UserClass>
+	void SetTimer(FWheelTimerHandle& InOutHandle, UserClass* InObj, typename FTimerDelegate::TMethodPtr<UserClass> InTimerMethod, float InRate, bool bInLoop = false, float InFirstDelay = -1.0f)
+	{
+		Wheel.SetTimer(InOutHandle, FTimerDelegate::CreateUObject(InObj, InTimerMethod), InRate, bInLoop, InFirstDelay);
+	}
+
+	void SetTimer(FWheelTimerHandle& InOutHandle, const FTimerDelegate& InDelegate, float InRate, bool bInLoop = false, float InFirstDelay = -1.0f)
+	{
+		Wheel.SetTimer(InOutHandle, InDelegate, InRate, bInLoop, InFirstDelay);
+	}
+
+	void ClearTimer(FWheelTimerHandle& InOutHandle) { Wheel.ClearTimer(InOutHandle); }
+	bool IsTimerActive(const FWheelTimerHandle& Handle) const { return Wheel.IsTimerActive(Handle); }
+	float GetTimerRemaining(const FWheelTimerHandle& Handle) const { return Wheel.GetTimerRemaining(Handle); }
+
+private:
+	FTimerWheel Wheel;
+};
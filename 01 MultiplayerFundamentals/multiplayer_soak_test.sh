@@ -0,0 +1,40 @@
+#!/bin/sh
+# Local soak test: one headless listen server and N headless bots on loopback with emulated latency,
+# jitter and loss. The host listens through HostLANGame, bots join through JoinLANGame, wander around
+# and spam sphere spawn and reliable server RPCs while the host plays cosmetic events on every character. Bots skip the
+# client-side rate limit (bBotsBypassClientRateLimit), so dropped RPCs are the server's. The host writes
+# frame time, bandwidth, dropped RPCs, sphere pool churn, cosmetic event traffic and reliable buffer
+# pressure to Saved/Profiling/Soak_MultiplayerCourse.json when the run ends. Run with 5% loss to compare reliable traffic.
+# Pass 0 for the replication graph to run the host on the legacy relevancy loop instead; compare frame time and
+# bandwidth against a run with the graph, which also reports its ServerReplicateActors time.
+#
+# Usage: ./multiplayer_soak_test.sh <path to UnrealEditor binary> [bots] [seconds] [lag ms] [jitter ms] [loss %] [replication graph 1|0]
+
+EDITOR_BIN=$1
+BOTS=${2:-4}
+DURATION=${3:-300}
+LAG=${4:-50}
+JITTER=${5:-10}
+LOSS=${6:-1}
+REPGRAPH=${7:-1}
+
+PROJECT="$(cd "$(dirname "$0")" && pwd)/MultiplayerCourse.uproject"
+HEADLESS="-game -nullrhi -nosound -unattended -log -SoakTest -SoakDuration=$DURATION"
+NET_EMULATION="-PktLag=$LAG -PktLagVariance=$JITTER -PktLoss=$LOSS"
+
+HOST_OPTIONS=""
+if [ "$REPGRAPH" = "0" ]; then
+	HOST_OPTIONS="-ini:Engine:[/Script/OnlineSubsystemUtils.IpNetDriver]:ReplicationDriverClassName="
+fi
+
+"$EDITOR_BIN" "$PROJECT" $HEADLESS $NET_EMULATION $HOST_OPTIONS -SoakHost > soak_host.log 2>&1 &
+HOST_PID=$!
+
+sleep 10
+
+for i in $(seq 1 $BOTS); do
+	"$EDITOR_BIN" "$PROJECT" $HEADLESS $NET_EMULATION -JoinAddress=127.0.0.1 > "soak_bot_$i.log" 2>&1 &
+done
+
+wait $HOST_PID
+wait
@@ -10,7 +10,7 @@ public class CoopAdventure : ModuleRules
 
 		PublicDependencyModuleNames.AddRange(new string[] { 
 			"Core", "CoreUObject", "Engine", "InputCore", "EnhancedInput", 
-			"OnlineSubsystem", "OnlineSubsystemSteam"
+			"OnlineSubsystem", "OnlineSubsystemSteam", "NetCore", "ReplicationGraph", "MultiplayerShared"
 		 });
 	}
 }
@@ -4,19 +4,28 @@
 #include "Engine/LocalPlayer.h"
 #include "Camera/CameraComponent.h"
 #include "Components/CapsuleComponent.h"
-#include "GameFramework/CharacterMovementComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "CoopCharacterMovementComponent.h"
+#include "SignificanceComponent.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "GameFramework/Controller.h"
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "InputActionValue.h"
+#include "HAL/IConsoleManager.h"
 
 DEFINE_LOG_CATEGORY(LogTemplateCharacter);
 
+static TAutoConsoleVariable<bool> CVarServerStripClientComponents(
+	TEXT("CoopAdventure.Server.StripClientComponents"),
+	true,
+	TEXT("Dedicated servers skip camera components and pose evaluation on newly spawned characters."));
+
 //////////////////////////////////////////////////////////////////////////
 // ACoopAdventureCharacter
 
-ACoopAdventureCharacter::ACoopAdventureCharacter()
+ACoopAdventureCharacter::ACoopAdventureCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UCoopCharacterMovementComponent>(ACharacter::CharacterMovementComponentName))
 {
 	// Set size for collision capsule
 	GetCapsuleComponent()->InitCapsuleSize(42.f, 96.0f);
@@ -50,10 +59,33 @@ ACoopAdventureCharacter::ACoopAdventureCharacter()
 	FollowCamera->SetupAttachment(CameraBoom, USpringArmComponent::SocketName); // Attach the camera to the end of the boom and let the boom adjust to match the controller orientation
 	FollowCamera->bUsePawnControlRotation = false; // Camera does not rotate relative to arm
 
+	// Distant characters animate and replicate less often
+	Significance = CreateDefaultSubobject<USignificanceComponent>(TEXT("Significance"));
+	Significance->TierSettings[(int32)ESignificanceTier::Medium].NetUpdateFrequency = 60.0f;
+	Significance->TierSettings[(int32)ESignificanceTier::Low].NetUpdateFrequency = 20.0f;
+	Significance->TierSettings[(int32)ESignificanceTier::Culled].NetUpdateFrequency = 10.0f;
+
 	// Note: The skeletal mesh and anim blueprint references on the Mesh component (inherited from Character) 
 	// are set in the derived blueprint asset named ThirdPersonCharacter (to avoid direct content references in C++)
 }
 
+void ACoopAdventureCharacter::PreRegisterAllComponents()
+{
+	if (IsRunningDedicatedServer() && CVarServerStripClientComponents.GetValueOnGameThread())
+	{
+		// Nothing looks through the camera on a server, so skip the spring arm's collision traces
+		CameraBoom->bAutoRegister = false;
+		FollowCamera->bAutoRegister = false;
+
+		if (!bServerNeedsBoneData)
+		{
+			GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+		}
+	}
+
+	Super::PreRegisterAllComponents();
+}
+
 void ACoopAdventureCharacter::BeginPlay()
 {
 	// Call the base class  
@@ -9,6 +9,7 @@
 
 class USpringArmComponent;
 class UCameraComponent;
+class USignificanceComponent;
 class UInputMappingContext;
 class UInputAction;
 struct FInputActionValue;
@@ -27,6 +28,10 @@ class ACoopAdventureCharacter : public ACharacter
 	/** Follow camera */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	UCameraComponent* FollowCamera;
+
+	/** Lowers tick and update rates for characters far from every player */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Performance, meta = (AllowPrivateAccess = "true"))
+	USignificanceComponent* Significance;
 	
 	/** MappingContext */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (AllowPrivateAccess = "true"))
@@ -45,7 +50,7 @@ class ACoopAdventureCharacter : public ACharacter
 	UInputAction* LookAction;
 
 public:
-	ACoopAdventureCharacter();
+	ACoopAdventureCharacter(const FObjectInitializer& ObjectInitializer);
 	
 
 protected:
@@ -64,10 +69,19 @@ protected:
 	// To add mapping context
 	virtual void BeginPlay();
 
+	// Keeps camera components from registering on dedicated servers, which never render
+	virtual void PreRegisterAllComponents() override;
+
+	// Dedicated servers only update montages unless this is set, e.g. for hit detection against bones
+	UPROPERTY(EditDefaultsOnly, Category = Server)
+	bool bServerNeedsBoneData = false;
+
 public:
 	/** Returns CameraBoom subobject **/
 	FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
 	/** Returns FollowCamera subobject **/
 	FORCEINLINE class UCameraComponent* GetFollowCamera() const { return FollowCamera; }
+	/** Returns Significance subobject **/
+	FORCEINLINE class USignificanceComponent* GetSignificance() const { return Significance; }
 };
 
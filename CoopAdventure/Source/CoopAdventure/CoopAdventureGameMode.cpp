@@ -3,6 +3,7 @@
 #include "CoopAdventureGameMode.h"
 #include "CoopAdventureCharacter.h"
 #include "UObject/ConstructorHelpers.h"
+#include "EngineUtils.h"
 
 ACoopAdventureGameMode::ACoopAdventureGameMode()
 {
@@ -12,4 +13,25 @@ ACoopAdventureGameMode::ACoopAdventureGameMode()
 	{
 		DefaultPawnClass = PlayerPawnBPClass.Class;
 	}
+
+	// Keep clients connected and reuse loaded assets when the listen server changes maps
+	bUseSeamlessTravel = true;
+}
+
+void ACoopAdventureGameMode::GetSeamlessTravelActorList(bool bToTransition, TArray<AActor*>& ActorList)
+{
+	Super::GetSeamlessTravelActorList(bToTransition, ActorList);
+
+	for (const TSubclassOf<AActor>& ActorClass : SeamlessTravelActorClasses)
+	{
+		if (!ActorClass)
+		{
+			continue;
+		}
+
+		for (TActorIterator<AActor> It(GetWorld(), ActorClass); It; ++It)
+		{
+			ActorList.AddUnique(*It);
+		}
+	}
 }
@@ -13,6 +13,12 @@ class ACoopAdventureGameMode : public AGameModeBase
 
 public:
 	ACoopAdventureGameMode();
+
+	virtual void GetSeamlessTravelActorList(bool bToTransition, TArray<AActor*>& ActorList) override;
+
+	// Actors of these classes are carried across seamless travel, in addition to the controllers and player states
+	UPROPERTY(EditDefaultsOnly, Category = Travel)
+	TArray<TSubclassOf<AActor>> SeamlessTravelActorClasses;
 };
 
 
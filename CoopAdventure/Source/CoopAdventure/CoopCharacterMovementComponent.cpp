@@ -0,0 +1,120 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CoopCharacterMovementComponent.h"
+#include "CoopAdventure.h"
+
+DECLARE_CYCLE_STAT(TEXT("Movement Correction Replay"), STAT_CoopMovementReplay, STATGROUP_CoopAdventure);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Movement Client Corrections"), STAT_CoopMovementClientCorrections, STATGROUP_CoopAdventure);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Movement Replayed Moves"), STAT_CoopMovementReplayedMoves, STATGROUP_CoopAdventure);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Movement Merged Moves"), STAT_CoopMovementMergedMoves, STATGROUP_CoopAdventure);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Movement Server Corrections"), STAT_CoopMovementServerCorrections, STATGROUP_CoopAdventure);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Movement Move RPCs"), STAT_CoopMovementMoveRPCs, STATGROUP_CoopAdventure);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Movement Move RPC Bytes"), STAT_CoopMovementMoveRPCBytes, STATGROUP_CoopAdventure);
+
+FSavedMove_Coop::FSavedMove_Coop(float InAccelDotThresholdCombine, float InMaxSpeedThresholdCombine)
+{
+	AccelDotThresholdCombine = InAccelDotThresholdCombine;
+	MaxSpeedThresholdCombine = InMaxSpeedThresholdCombine;
+}
+
+FNetworkPredictionData_Client_Coop::FNetworkPredictionData_Client_Coop(const UCoopCharacterMovementComponent& ClientMovement)
+	: FNetworkPredictionData_Client_Character(ClientMovement)
+	, AccelDotThresholdCombine(ClientMovement.AccelDotThresholdCombine)
+	, MaxSpeedThresholdCombine(ClientMovement.MaxSpeedThresholdCombine)
+{
+}
+
+FSavedMovePtr FNetworkPredictionData_Client_Coop::AllocateNewMove()
+{
+	return FSavedMovePtr(new FSavedMove_Coop(AccelDotThresholdCombine, MaxSpeedThresholdCombine));
+}
+
+int32 FNetworkPredictionData_Client_Coop::MergeOldSavedMoves(ACharacter* Character, int32 MaxMoves)
+{
+	// Replay only uses a move's delta time, acceleration and flags, so two moves that could have been
+	// sent as one replay the same as a single move with their combined delta time. The newer move keeps
+	// its timestamp, so acknowledgements still line up.
+	const float MaxDelta = MaxMoveDeltaTime * Character->GetActorTimeDilation();
+	int32 NumMerged = 0;
+	int32 Index = 0;
+	while (SavedMoves.Num() > MaxMoves && Index < SavedMoves.Num() - 1)
+	{
+		const FSavedMovePtr& OldMove = SavedMoves[Index];
+		const FSavedMovePtr& NewMove = SavedMoves[Index + 1];
+		if (OldMove->CanCombineWith(NewMove, Character, MaxDelta))
+		{
+			NewMove->DeltaTime += OldMove->DeltaTime;
+			FreeMove(OldMove);
+			SavedMoves.RemoveAt(Index, 1, false);
+			++NumMerged;
+		}
+		else
+		{
+			++Index;
+		}
+	}
+
+	return NumMerged;
+}
+
+FNetworkPredictionData_Client* UCoopCharacterMovementComponent::GetPredictionData_Client() const
+{
+	if (ClientPredictionData == nullptr)
+	{
+		UCoopCharacterMovementComponent* MutableThis = const_cast<UCoopCharacterMovementComponent*>(this);
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_Coop(*this);
+		MutableThis->ClientPredictionData->MaxSmoothNetUpdateDist = NetworkMaxSmoothUpdateDistance;
+		MutableThis->ClientPredictionData->NoSmoothNetUpdateDist = NetworkNoSmoothUpdateDistance;
+	}
+
+	return ClientPredictionData;
+}
+
+bool UCoopCharacterMovementComponent::ClientUpdatePositionAfterServerUpdate()
+{
+	FNetworkPredictionData_Client_Coop* ClientData = HasPredictionData_Client() ? static_cast<FNetworkPredictionData_Client_Coop*>(GetPredictionData_Client_Character()) : nullptr;
+	if (!ClientData || !ClientData->bUpdatePosition)
+	{
+		return Super::ClientUpdatePositionAfterServerUpdate();
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_CoopMovementReplay);
+	INC_DWORD_STAT(STAT_CoopMovementClientCorrections);
+
+	[[maybe_unused]] const int32 NumMerged = ClientData->MergeOldSavedMoves(CharacterOwner, FMath::Max(MaxReplayedMoves, 1));
+	INC_DWORD_STAT_BY(STAT_CoopMovementMergedMoves, NumMerged);
+	INC_DWORD_STAT_BY(STAT_CoopMovementReplayedMoves, ClientData->SavedMoves.Num());
+
+	return Super::ClientUpdatePositionAfterServerUpdate();
+}
+
+void UCoopCharacterMovementComponent::SendClientAdjustment()
+{
+	const FNetworkPredictionData_Server_Character* ServerData = HasPredictionData_Server() ? GetPredictionData_Server_Character() : nullptr;
+	if (ServerData && ServerData->PendingAdjustment.TimeStamp > 0.0f && !ServerData->PendingAdjustment.bAckGoodMove)
+	{
+		INC_DWORD_STAT(STAT_CoopMovementServerCorrections);
+
+		if (UCoopMovementStatsSubsystem* MovementStats = GetWorld()->GetSubsystem<UCoopMovementStatsSubsystem>())
+		{
+			MovementStats->AddServerCorrection();
+		}
+	}
+
+	Super::SendClientAdjustment();
+}
+
+void UCoopCharacterMovementComponent::ServerMovePacked_ClientSend(const FCharacterServerMovePackedBits& PackedBits)
+{
+	INC_DWORD_STAT(STAT_CoopMovementMoveRPCs);
+	INC_DWORD_STAT_BY(STAT_CoopMovementMoveRPCBytes, (PackedBits.DataBits.Num() + 7) / 8);
+
+	Super::ServerMovePacked_ClientSend(PackedBits);
+}
+
+bool UCoopMovementStatsSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && Super::ShouldCreateSubsystem(Outer);
+}
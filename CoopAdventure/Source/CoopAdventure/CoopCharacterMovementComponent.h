@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CoopCharacterMovementComponent.generated.h"
+
+class UCoopCharacterMovementComponent;
+
+// Saved move with looser combine thresholds, so steady input collapses into fewer ServerMove RPCs
+class FSavedMove_Coop : public FSavedMove_Character
+{
+public:
+	FSavedMove_Coop(float InAccelDotThresholdCombine, float InMaxSpeedThresholdCombine);
+};
+
+class FNetworkPredictionData_Client_Coop : public FNetworkPredictionData_Client_Character
+{
+public:
+	FNetworkPredictionData_Client_Coop(const UCoopCharacterMovementComponent& ClientMovement);
+
+	virtual FSavedMovePtr AllocateNewMove() override;
+
+	// Merges the oldest combinable saved moves until at most MaxMoves are left, returns how many were merged
+	int32 MergeOldSavedMoves(ACharacter* Character, int32 MaxMoves);
+
+private:
+	float AccelDotThresholdCombine;
+	float MaxSpeedThresholdCombine;
+};
+
+/**
+ * Character movement for ACoopAdventureCharacter, tuned for lossy links.
+ * Combines more moves per RPC, merges old saved moves so a correction replays at most MaxReplayedMoves,
+ * and counts corrections, replay time and move RPC size under 'stat CoopAdventure'.
+ * Server correction tolerance lives in [/Script/Engine.GameNetworkManager] in DefaultGame.ini.
+ */
+UCLASS(Config = Game)
+class COOPADVENTURE_API UCoopCharacterMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+public:
+	virtual FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+
+	virtual bool ClientUpdatePositionAfterServerUpdate() override;
+	virtual void SendClientAdjustment() override;
+	virtual void ServerMovePacked_ClientSend(const FCharacterServerMovePackedBits& PackedBits) override;
+
+	// Most moves replayed after a correction. Older combinable saved moves are merged to stay under it,
+	// the saved move history itself keeps the engine's limit.
+	UPROPERTY(Config, EditAnywhere, Category = "Character Movement (Networking)")
+	int32 MaxReplayedMoves = 24;
+
+	// Moves whose acceleration directions have a dot product above this are combined (engine default 0.996)
+	UPROPERTY(Config, EditAnywhere, Category = "Character Movement (Networking)")
+	float AccelDotThresholdCombine = 0.99f;
+
+	// Moves whose max speeds differ by less than this are combined (engine default 10)
+	UPROPERTY(Config, EditAnywhere, Category = "Character Movement (Networking)")
+	float MaxSpeedThresholdCombine = 20.0f;
+};
+
+// Per-world movement counters for soak test reports
+UCLASS()
+class COOPADVENTURE_API UCoopMovementStatsSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	void AddServerCorrection() { ++NumServerCorrections; }
+
+	// Corrections the server sent to clients in this world
+	int32 GetNumServerCorrections() const { return NumServerCorrections; }
+
+private:
+	int32 NumServerCorrections = 0;
+};
@@ -0,0 +1,127 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CoopReplicationGraph.h"
+#include "CoopAdventure.h"
+#include "NetRelevancyPolicyComponent.h"
+#include "PuzzleRoomVolume.h"
+#include "PuzzleStateReplicator.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("RepGraph Puzzle Room Actors"), STAT_RepGraphPuzzleRoomActors, STATGROUP_CoopAdventure);
+
+void UCoopReplicationGraph::InitClassRepNodePolicies()
+{
+	// Plates carry no replicated state of their own and are mapped from their dormant CDO
+	SetClassRepNodePolicy(APuzzleStateReplicator::StaticClass(), EMultiplayerClassRepNodeMapping::Custom);
+}
+
+void UCoopReplicationGraph::InitGlobalGraphNodes()
+{
+	Super::InitGlobalGraphNodes();
+
+	PuzzleRoomNode = CreateNewNode<UCoopReplicationGraphNode_PuzzleRooms>();
+	AddGlobalGraphNode(PuzzleRoomNode);
+}
+
+void UCoopReplicationGraph::RouteAddCustomActor(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	PuzzleRoomNode->NotifyAddNetworkActor(ActorInfo);
+}
+
+void UCoopReplicationGraph::RouteRemoveCustomActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+	PuzzleRoomNode->NotifyRemoveNetworkActor(ActorInfo);
+}
+
+void UCoopReplicationGraph::ApplyRelevancyPolicy(const AActor* Actor, FGlobalActorReplicationInfo& GlobalInfo) const
+{
+	if (const UNetRelevancyPolicyComponent* Policy = Actor ? Actor->FindComponentByClass<UNetRelevancyPolicyComponent>() : nullptr)
+	{
+		ApplyRelevancySettings(GlobalInfo, Policy->NetCullDistance, Policy->NetUpdateFrequency);
+	}
+}
+
+void UCoopReplicationGraphNode_PuzzleRooms::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+	PendingActors.Add(ActorInfo);
+}
+
+bool UCoopReplicationGraphNode_PuzzleRooms::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	if (PendingActors.RemoveAllSwap([&ActorInfo](const FNewReplicatedActorInfo& Pending) { return Pending.Actor == ActorInfo.Actor; }) > 0)
+	{
+		return true;
+	}
+
+	if (RoomlessActors.RemoveFast(ActorInfo.Actor))
+	{
+		return true;
+	}
+
+	for (TPair<FName, FActorRepListRefView>& Room : RoomActors)
+	{
+		if (Room.Value.RemoveFast(ActorInfo.Actor))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UCoopReplicationGraphNode_PuzzleRooms::NotifyResetAllNetworkActors()
+{
+	PendingActors.Reset();
+	RoomlessActors.Reset();
+	RoomActors.Reset();
+}
+
+void UCoopReplicationGraphNode_PuzzleRooms::SortPendingActors()
+{
+	for (const FNewReplicatedActorInfo& ActorInfo : PendingActors)
+	{
+		AActor* Actor = ActorInfo.GetActor();
+		const UNetRelevancyPolicyComponent* Policy = Actor->FindComponentByClass<UNetRelevancyPolicyComponent>();
+		const FName RoomName = (Policy && Policy->bRelevantOnlyInSameRoom) ? Policy->RoomName : NAME_None;
+
+		if (RoomName.IsNone())
+		{
+			RoomlessActors.Add(Actor);
+		}
+		else
+		{
+			RoomActors.FindOrAdd(RoomName).Add(Actor);
+		}
+	}
+
+	PendingActors.Reset();
+}
+
+void UCoopReplicationGraphNode_PuzzleRooms::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	if (PendingActors.Num() > 0)
+	{
+		SortPendingActors();
+	}
+
+	if (RoomlessActors.Num() > 0)
+	{
+		Params.OutGatheredReplicationLists.AddReplicationActorList(RoomlessActors);
+	}
+
+	UPuzzleRoomSubsystem* RoomSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UPuzzleRoomSubsystem>() : nullptr;
+	if (!RoomSubsystem || RoomActors.Num() == 0)
+	{
+		return;
+	}
+
+	for (const FNetViewer& Viewer : Params.Viewers)
+	{
+		const FName ViewerRoom = RoomSubsystem->FindViewerRoom(Viewer.ViewTarget ? Viewer.ViewTarget : Viewer.InViewer);
+		if (const FActorRepListRefView* Room = RoomActors.Find(ViewerRoom))
+		{
+			Params.OutGatheredReplicationLists.AddReplicationActorList(*Room);
+			INC_DWORD_STAT_BY(STAT_RepGraphPuzzleRoomActors, Room->Num());
+		}
+	}
+}
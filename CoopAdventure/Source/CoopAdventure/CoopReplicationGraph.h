@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MultiplayerReplicationGraph.h"
+#include "CoopReplicationGraph.generated.h"
+
+class UCoopReplicationGraphNode_PuzzleRooms;
+
+/**
+ * Replication graph for CoopAdventure. Adds per-room lists for the puzzle state replicators to the
+ * shared graph, so plate state only replicates to players standing in the same APuzzleRoomVolume.
+ * Enabled through ReplicationDriverClassName in DefaultEngine.ini.
+ */
+UCLASS(Transient, Config = Engine)
+class COOPADVENTURE_API UCoopReplicationGraph : public UMultiplayerReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+	virtual void InitGlobalGraphNodes() override;
+
+	UPROPERTY()
+	TObjectPtr<UCoopReplicationGraphNode_PuzzleRooms> PuzzleRoomNode;
+
+protected:
+	virtual void InitClassRepNodePolicies() override;
+	virtual void RouteAddCustomActor(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveCustomActor(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual void ApplyRelevancyPolicy(const AActor* Actor, FGlobalActorReplicationInfo& GlobalInfo) const override;
+};
+
+/**
+ * Puzzle actors grouped by the RoomName of their UNetRelevancyPolicyComponent. A connection only
+ * gathers the list for the room its view target is standing in. Actors are sorted into rooms on
+ * the first gather after they are added, once deferred spawns have set their room; actors without
+ * a room are gathered for every connection.
+ */
+UCLASS()
+class COOPADVENTURE_API UCoopReplicationGraphNode_PuzzleRooms : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override;
+	virtual void NotifyResetAllNetworkActors() override;
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+private:
+	void SortPendingActors();
+
+	TArray<FNewReplicatedActorInfo> PendingActors;
+	FActorRepListRefView RoomlessActors;
+	TMap<FName, FActorRepListRefView> RoomActors;
+};
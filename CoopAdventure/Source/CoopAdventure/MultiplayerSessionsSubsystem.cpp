@@ -3,13 +3,18 @@
 
 #include "MultiplayerSessionsSubsystem.h"
 #include "OnlineSubsystem.h"
+#include "TimerManager.h"
+#include "UObject/UObjectGlobals.h"
+#include "GameFramework/GameModeBase.h"
 
 void PrintString(const FString& Str)
 {
+#if !UE_SERVER
     if (GEngine)
     {
         GEngine->AddOnScreenDebugMessage(-1, 15.0f, FColor::Cyan, Str);
     }
+#endif
 }
 
 UMultiplayerSessionsSubsystem::UMultiplayerSessionsSubsystem()
@@ -20,6 +25,27 @@ UMultiplayerSessionsSubsystem::UMultiplayerSessionsSubsystem()
     DestroyServerName = "";
     ServerNameToFind = "";
     MySessionName = FName("Co-op Adventure Session Name");
+
+    NumPublicConnections = 2;
+    SearchDedicatedServers = false;
+    DedicatedServerName = "CoopAdventure Dedicated";
+
+    BrowserRefreshInFlight = false;
+    FindServerInFlight = false;
+    FindServerAfterRefresh = false;
+    JoiningFromCache = false;
+    JoinRequestTime = 0.0;
+    SessionBrowserRefreshInterval = 15.0f;
+    SessionBrowserMaxCacheAge = 60.0f;
+
+    HostStartupInProgress = false;
+    MapPreloadInFlight = false;
+    SessionReadyForTravel = false;
+    TravelIsSeamless = false;
+    HostStartTime = 0.0;
+    SessionCreatedTime = 0.0;
+    MapPreloadedTime = 0.0;
+    TravelStartTime = 0.0;
 }
 
 void UMultiplayerSessionsSubsystem::Initialize(FSubsystemCollectionBase& Collection)
@@ -49,11 +75,17 @@ void UMultiplayerSessionsSubsystem::Initialize(FSubsystemCollectionBase& Collect
             );
         }
     }
+
+    FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UMultiplayerSessionsSubsystem::OnPostLoadMapWithWorld);
 }
 
 void UMultiplayerSessionsSubsystem::Deinitialize()
 {
     //UE_LOG(LogTemp, Warning, TEXT("MSS Deinitialize"));
+
+    StopSessionBrowser();
+
+    FCoreUObjectDelegates::PostLoadMapWithWorld.RemoveAll(this);
 }
 
 void UMultiplayerSessionsSubsystem::CreateServer(FString ServerName)
@@ -67,6 +99,18 @@ void UMultiplayerSessionsSubsystem::CreateServer(FString ServerName)
         return;
     }
 
+    // Hosting doesn't need the browser, and its searches would compete with the session being created
+    StopSessionBrowser();
+
+    // A dedicated server is already running the game map, so there's nothing to travel to
+    if (!HostStartupInProgress && !IsRunningDedicatedServer())
+    {
+        HostStartupInProgress = true;
+        SessionReadyForTravel = false;
+        HostStartTime = FPlatformTime::Seconds();
+        PreloadGameMap();
+    }
+
     FNamedOnlineSession *ExistingSession = SessionInterface->GetNamedSession(MySessionName);
     if (ExistingSession)
     {
@@ -80,14 +124,16 @@ void UMultiplayerSessionsSubsystem::CreateServer(FString ServerName)
         return;
     }
 
+    const bool IsDedicated = IsRunningDedicatedServer();
+
     FOnlineSessionSettings SessionSettings;
     SessionSettings.bAllowJoinInProgress = true;
-    SessionSettings.bIsDedicated = false;
+    SessionSettings.bIsDedicated = IsDedicated;
     SessionSettings.bShouldAdvertise = true;
-    SessionSettings.NumPublicConnections = 2;
-    SessionSettings.bUseLobbiesIfAvailable = true;
-    SessionSettings.bUsesPresence = true;
-    SessionSettings.bAllowJoinViaPresence = true;
+    SessionSettings.NumPublicConnections = NumPublicConnections;
+    SessionSettings.bUseLobbiesIfAvailable = !IsDedicated;
+    SessionSettings.bUsesPresence = !IsDedicated;
+    SessionSettings.bAllowJoinViaPresence = !IsDedicated;
 
     bool IsLAN = false;
     if (IOnlineSubsystem::Get()->GetSubsystemName() == "NULL")
@@ -96,7 +142,7 @@ void UMultiplayerSessionsSubsystem::CreateServer(FString ServerName)
     }
     SessionSettings.bIsLANMatch = IsLAN;
 
-    SessionSettings.Set(FName("SERVER_NAME"), ServerName, EOnlineDataAdvertisementType::ViaOnlineServiceAndPing);
+    SessionSettings.Set(SETTING_SERVER_NAME, ServerName, EOnlineDataAdvertisementType::ViaOnlineServiceAndPing);
 
     SessionInterface->CreateSession(0, MySessionName, SessionSettings);
 }
@@ -112,6 +158,26 @@ void UMultiplayerSessionsSubsystem::FindServer(FString ServerName)
         return;
     }
 
+    ServerNameToFind = ServerName;
+    JoinRequestTime = FPlatformTime::Seconds();
+
+    if (TryJoinFromCache())
+    {
+        return;
+    }
+
+    if (BrowserRefreshInFlight)
+    {
+        // Only one search can run at a time; the refresh result is checked first
+        FindServerAfterRefresh = true;
+        return;
+    }
+
+    StartFindServerSearch();
+}
+
+void UMultiplayerSessionsSubsystem::StartFindServerSearch()
+{
     bool IsLAN = false;
     if (IOnlineSubsystem::Get()->GetSubsystemName() == "NULL")
     {
@@ -120,29 +186,249 @@ void UMultiplayerSessionsSubsystem::FindServer(FString ServerName)
 
     SessionSearch = MakeShareable(new FOnlineSessionSearch());
     SessionSearch->bIsLanQuery = IsLAN;
-    SessionSearch->MaxSearchResults = 9999;
-    SessionSearch->QuerySettings.Set(SEARCH_PRESENCE, true, EOnlineComparisonOp::Equals);
-
-    ServerNameToFind = ServerName;
+    // Services that ignore the name filter (e.g. the NULL subsystem's LAN beacon) return every
+    // session, so leave room for the matching one to be among them
+    SessionSearch->MaxSearchResults = 100;
+    if (!SearchDedicatedServers)
+    {
+        SessionSearch->QuerySettings.Set(SEARCH_PRESENCE, true, EOnlineComparisonOp::Equals);
+    }
+    SessionSearch->QuerySettings.Set(SETTING_SERVER_NAME, ServerNameToFind, EOnlineComparisonOp::Equals);
 
+    FindServerInFlight = true;
     SessionInterface->FindSessions(0, SessionSearch.ToSharedRef());
 }
 
-void UMultiplayerSessionsSubsystem::OnCreateSessionComplete(FName SessionName, bool bWasSuccessful)
+bool UMultiplayerSessionsSubsystem::TryJoinFromCache()
 {
-    PrintString(FString::Printf(TEXT("OnCreateSessionComplete: %d"), bWasSuccessful));
+    const FCachedSession* Cached = SessionBrowserCache.Find(ServerNameToFind);
+    if (!Cached || FPlatformTime::Seconds() - Cached->CacheTime > SessionBrowserMaxCacheAge)
+    {
+        return false;
+    }
 
-    ServerCreateDel.Broadcast(bWasSuccessful);
+    // JoinSession revalidates the session with the online service; if it fails we fall back to a search
+    PrintString(FString::Printf(TEXT("Joining cached server with name: %s"), *ServerNameToFind));
+    JoiningFromCache = true;
+    PendingConnectString = Cached->ConnectString;
+    SessionInterface->JoinSession(0, MySessionName, Cached->Result);
+    return true;
+}
+
+void UMultiplayerSessionsSubsystem::StartSessionBrowser()
+{
+    if (!SessionInterface.IsValid() || SessionBrowserRefreshInterval <= 0.0f)
+    {
+        return;
+    }
+
+    GetGameInstance()->GetTimerManager().SetTimer(SessionBrowserTimer, this,
+        &UMultiplayerSessionsSubsystem::RefreshSessionBrowser, SessionBrowserRefreshInterval, true, 0.0f);
+}
+
+void UMultiplayerSessionsSubsystem::StopSessionBrowser()
+{
+    if (UGameInstance* GameInstance = GetGameInstance())
+    {
+        GameInstance->GetTimerManager().ClearTimer(SessionBrowserTimer);
+    }
+}
 
+void UMultiplayerSessionsSubsystem::RefreshSessionBrowser()
+{
+    if (BrowserRefreshInFlight || FindServerInFlight || JoiningFromCache)
+    {
+        return;
+    }
+
+    BrowserSearch = MakeShareable(new FOnlineSessionSearch());
+    BrowserSearch->bIsLanQuery = IOnlineSubsystem::Get()->GetSubsystemName() == "NULL";
+    BrowserSearch->MaxSearchResults = 100;
+    if (!SearchDedicatedServers)
+    {
+        BrowserSearch->QuerySettings.Set(SEARCH_PRESENCE, true, EOnlineComparisonOp::Equals);
+    }
+
+    BrowserRefreshInFlight = true;
+    SessionInterface->FindSessions(0, BrowserSearch.ToSharedRef());
+}
+
+void UMultiplayerSessionsSubsystem::OnSessionBrowserRefreshComplete(bool bWasSuccessful)
+{
     if (bWasSuccessful)
     {
-        FString Path = "/Game/ThirdPerson/Maps/ThirdPersonMap?listen";
-        if (!GameMapPath.IsEmpty())
+        CacheSearchResults(BrowserSearch->SearchResults, true);
+    }
+
+    if (FindServerAfterRefresh)
+    {
+        FindServerAfterRefresh = false;
+        if (!TryJoinFromCache())
+        {
+            StartFindServerSearch();
+        }
+    }
+}
+
+void UMultiplayerSessionsSubsystem::CacheSearchResults(const TArray<FOnlineSessionSearchResult>& Results, bool ReplaceCache)
+{
+    if (ReplaceCache)
+    {
+        SessionBrowserCache.Reset();
+    }
+
+    const double Now = FPlatformTime::Seconds();
+    for (const FOnlineSessionSearchResult& Result : Results)
+    {
+        FString ServerName;
+        if (!Result.IsValid() || !Result.Session.SessionSettings.Get(SETTING_SERVER_NAME, ServerName))
         {
-            Path = FString::Printf(TEXT("%s?listen"), *GameMapPath);
+            continue;
         }
 
-        GetWorld()->ServerTravel(GameMapPath);
+        FCachedSession& Cached = SessionBrowserCache.FindOrAdd(ServerName);
+        Cached.Result = Result;
+        Cached.CacheTime = Now;
+        Cached.ConnectString.Reset();
+        SessionInterface->GetResolvedConnectString(Result, NAME_GamePort, Cached.ConnectString);
+    }
+}
+
+FString UMultiplayerSessionsSubsystem::GetGameMapPackageName() const
+{
+    FString MapPath = GameMapPath.IsEmpty() ? FString("/Game/ThirdPerson/Maps/ThirdPersonMap") : GameMapPath;
+
+    // Drop any travel options, e.g. "?listen"
+    FString PackageName;
+    if (MapPath.Split(TEXT("?"), &PackageName, nullptr))
+    {
+        return PackageName;
+    }
+    return MapPath;
+}
+
+void UMultiplayerSessionsSubsystem::PreloadGameMap()
+{
+    const FString PackageName = GetGameMapPackageName();
+    if (PreloadedMapPackage && PreloadedMapPackage->GetName() == PackageName)
+    {
+        MapPreloadedTime = FPlatformTime::Seconds();
+        return;
+    }
+
+    MapPreloadInFlight = true;
+    LoadPackageAsync(PackageName, FLoadPackageAsyncDelegate::CreateUObject(
+        this, &UMultiplayerSessionsSubsystem::OnGameMapPreloaded));
+}
+
+void UMultiplayerSessionsSubsystem::OnGameMapPreloaded(const FName& PackageName, UPackage* LoadedPackage, EAsyncLoadingResult::Type Result)
+{
+    MapPreloadInFlight = false;
+    MapPreloadedTime = FPlatformTime::Seconds();
+
+    if (Result == EAsyncLoadingResult::Succeeded)
+    {
+        PreloadedMapPackage = LoadedPackage;
+    }
+    else
+    {
+        // ServerTravel will still load the map itself
+        PrintString(FString::Printf(TEXT("Failed to preload %s"), *PackageName.ToString()));
+    }
+
+    TravelToGameMapIfReady();
+}
+
+void UMultiplayerSessionsSubsystem::TravelToGameMapIfReady()
+{
+    if (!HostStartupInProgress || !SessionReadyForTravel || MapPreloadInFlight)
+    {
+        return;
+    }
+
+    HostStartupInProgress = false;
+    SessionReadyForTravel = false;
+    TravelStartTime = FPlatformTime::Seconds();
+
+    UE_LOG(LogTemp, Log, TEXT("Host startup: session ready after %.1f ms, map preloaded after %.1f ms"),
+        (SessionCreatedTime - HostStartTime) * 1000.0, (MapPreloadedTime - HostStartTime) * 1000.0);
+
+    // Seamless travel keeps connected clients but can only be used once we're already listening
+    UWorld* World = GetWorld();
+    const AGameModeBase* GameMode = World->GetAuthGameMode();
+    TravelIsSeamless = World->GetNetMode() == NM_ListenServer && GameMode && GameMode->bUseSeamlessTravel;
+    if (TravelIsSeamless)
+    {
+        World->ServerTravel(GetGameMapPackageName());
+    }
+    else
+    {
+        World->ServerTravel(FString::Printf(TEXT("%s?listen"), *GetGameMapPackageName()));
+    }
+}
+
+void UMultiplayerSessionsSubsystem::StartDedicatedServerSession()
+{
+    if (!SessionInterface.IsValid() || SessionInterface->GetNamedSession(MySessionName))
+    {
+        return;
+    }
+
+    FString ServerName;
+    if (!FParse::Value(FCommandLine::Get(), TEXT("ServerName="), ServerName))
+    {
+        ServerName = DedicatedServerName;
+    }
+
+    CreateServer(ServerName);
+}
+
+void UMultiplayerSessionsSubsystem::OnPostLoadMapWithWorld(UWorld* LoadedWorld)
+{
+    if (IsRunningDedicatedServer())
+    {
+        StartDedicatedServerSession();
+        return;
+    }
+
+    // A standalone world is the main menu, keep the browser cache warm there so FindServer usually
+    // joins without a search; once hosting or connected there is nothing to browse for
+    if (LoadedWorld && LoadedWorld->GetNetMode() == NM_Standalone)
+    {
+        StartSessionBrowser();
+    }
+    else
+    {
+        StopSessionBrowser();
+    }
+
+    if (!PreloadedMapPackage || !LoadedWorld || LoadedWorld->GetOutermost() != PreloadedMapPackage)
+    {
+        return;
+    }
+
+    PreloadedMapPackage = nullptr;
+
+    const double Now = FPlatformTime::Seconds();
+    UE_LOG(LogTemp, Log, TEXT("Host startup: %s travel took %.1f ms, %.1f ms total from CreateServer to playable"),
+        TravelIsSeamless ? TEXT("seamless") : TEXT("hard"), (Now - TravelStartTime) * 1000.0, (Now - HostStartTime) * 1000.0);
+}
+
+void UMultiplayerSessionsSubsystem::OnCreateSessionComplete(FName SessionName, bool bWasSuccessful)
+{
+    PrintString(FString::Printf(TEXT("OnCreateSessionComplete: %d"), bWasSuccessful));
+
+    ServerCreateDel.Broadcast(bWasSuccessful);
+
+    if (bWasSuccessful)
+    {
+        SessionCreatedTime = FPlatformTime::Seconds();
+        SessionReadyForTravel = true;
+        TravelToGameMapIfReady();
+    }
+    else
+    {
+        HostStartupInProgress = false;
     }
 }
 
@@ -161,40 +447,49 @@ void UMultiplayerSessionsSubsystem::OnDestroySessionComplete(FName SessionName,
 
 void UMultiplayerSessionsSubsystem::OnFindSessionsComplete(bool bWasSuccessful)
 {
+    if (BrowserRefreshInFlight)
+    {
+        BrowserRefreshInFlight = false;
+        OnSessionBrowserRefreshComplete(bWasSuccessful);
+        return;
+    }
+
+    FindServerInFlight = false;
+
     if (!bWasSuccessful || ServerNameToFind.IsEmpty()) 
     {
         ServerJoinDel.Broadcast(false);
         return;
     }
 
-    TArray<FOnlineSessionSearchResult> Results = SessionSearch->SearchResults;
-    FOnlineSessionSearchResult* CorrectResult = 0;
+    // Services that ignore the query filter (e.g. LAN) still return everything, so match by name here too
+    const TArray<FOnlineSessionSearchResult>& Results = SessionSearch->SearchResults;
+
+    SearchResultIndexByName.Reset();
+    SearchResultIndexByName.Reserve(Results.Num());
+    for (int32 ResultIdx = 0; ResultIdx < Results.Num(); ++ResultIdx)
+    {
+        const FOnlineSessionSearchResult& Result = Results[ResultIdx];
+        FString ServerName;
+        if (Result.IsValid() && Result.Session.SessionSettings.Get(SETTING_SERVER_NAME, ServerName)
+            && !SearchResultIndexByName.Contains(ServerName))
+        {
+            SearchResultIndexByName.Add(MoveTemp(ServerName), ResultIdx);
+        }
+    }
+
+    CacheSearchResults(Results, false);
 
     if (Results.Num() > 0)
     {
         FString Msg = FString::Printf(TEXT("%d sessions found."), Results.Num());
         PrintString(Msg);
 
-        for (FOnlineSessionSearchResult Result : Results)
+        if (const int32* ResultIdx = SearchResultIndexByName.Find(ServerNameToFind))
         {
-            if (Result.IsValid())
-            {
-                FString ServerName = "No-name";
-                Result.Session.SessionSettings.Get(FName("SERVER_NAME"), ServerName);
-
-                if (ServerName.Equals(ServerNameToFind))
-                {
-                    CorrectResult = &Result;
-                    FString Msg2 = FString::Printf(TEXT("Found server with name: %s"), *ServerName);
-                    PrintString(Msg2);
-                    break;
-                }
-            }
-        }
-
-        if (CorrectResult)
-        {
-            SessionInterface->JoinSession(0, MySessionName, *CorrectResult);
+            PrintString(FString::Printf(TEXT("Found server with name: %s"), *ServerNameToFind));
+            PendingConnectString.Reset();
+            SessionInterface->JoinSession(0, MySessionName, Results[*ResultIdx]);
         }
         else
         {
@@ -212,6 +507,18 @@ void UMultiplayerSessionsSubsystem::OnFindSessionsComplete(bool bWasSuccessful)
 
 void UMultiplayerSessionsSubsystem::OnJoinSessionComplete(FName SessionName, EOnJoinSessionCompleteResult::Type Result)
 {
+    if (JoiningFromCache)
+    {
+        JoiningFromCache = false;
+        if (Result != EOnJoinSessionCompleteResult::Success)
+        {
+            PrintString("Cached session is no longer valid, searching again...");
+            SessionBrowserCache.Remove(ServerNameToFind);
+            StartFindServerSearch();
+            return;
+        }
+    }
+
     ServerJoinDel.Broadcast(Result == EOnJoinSessionCompleteResult::Success);
 
     if (Result == EOnJoinSessionCompleteResult::Success)
@@ -219,11 +526,13 @@ void UMultiplayerSessionsSubsystem::OnJoinSessionComplete(FName SessionName, EOn
         FString Msg = FString::Printf(TEXT("Successfully joined session %s"), *SessionName.ToString());
         PrintString(Msg);
 
-        FString Address = "";
-        bool Success = SessionInterface->GetResolvedConnectString(SessionName, Address);
+        FString Address = PendingConnectString;
+        PendingConnectString.Reset();
+        bool Success = !Address.IsEmpty() || SessionInterface->GetResolvedConnectString(SessionName, Address);
         if (Success)
         {
             PrintString(FString::Printf(TEXT("Address: %s"), *Address));
+            UE_LOG(LogTemp, Log, TEXT("Join to travel took %.1f ms"), (FPlatformTime::Seconds() - JoinRequestTime) * 1000.0);
             APlayerController *PlayerController = GetGameInstance()->GetFirstLocalPlayerController();
             if (PlayerController)
             {
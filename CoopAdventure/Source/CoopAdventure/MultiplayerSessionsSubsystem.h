@@ -9,13 +9,16 @@
 #include "Online/OnlineSessionNames.h"
 #include "MultiplayerSessionsSubsystem.generated.h"
 
+// Session setting holding the user-facing server name, advertised and used as a search filter
+#define SETTING_SERVER_NAME FName(TEXT("SERVER_NAME"))
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FServerCreateDelegate, bool, bWasSuccessful);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FServerJoinDelegate, bool, bWasSuccessful);
 
 /**
  * 
  */
-UCLASS()
+UCLASS(Config=Game)
 class COOPADVENTURE_API UMultiplayerSessionsSubsystem : public UGameInstanceSubsystem
 {
 	GENERATED_BODY()
@@ -34,18 +37,88 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void FindServer(FString ServerName);
 
+	// Keeps SessionBrowserCache filled by searching for all sessions every SessionBrowserRefreshInterval
+	// seconds, so FindServer can join a cached session without waiting for a search. Started whenever a
+	// standalone (menu) map loads and stopped when hosting or joining; SessionBrowserRefreshInterval 0 turns it off.
+	UFUNCTION(BlueprintCallable)
+	void StartSessionBrowser();
+
+	UFUNCTION(BlueprintCallable)
+	void StopSessionBrowser();
+
+	void RefreshSessionBrowser();
+	void OnSessionBrowserRefreshComplete(bool bWasSuccessful);
+
+	void StartFindServerSearch();
+	bool TryJoinFromCache();
+	void CacheSearchResults(const TArray<FOnlineSessionSearchResult>& Results, bool ReplaceCache);
+
+	// Host startup: the game map is loaded asynchronously while the session is destroyed/created,
+	// and ServerTravel starts once both are done
+	FString GetGameMapPackageName() const;
+	void PreloadGameMap();
+	void OnGameMapPreloaded(const FName& PackageName, UPackage* LoadedPackage, EAsyncLoadingResult::Type Result);
+	void TravelToGameMapIfReady();
+	void OnPostLoadMapWithWorld(UWorld* LoadedWorld);
+
+	// Dedicated servers advertise their own session once the map is loaded
+	void StartDedicatedServerSession();
+
 	void OnCreateSessionComplete(FName SessionName, bool bWasSuccessful);
 	void OnDestroySessionComplete(FName SessionName, bool bWasSuccessful);
 	void OnFindSessionsComplete(bool bWasSuccessful);
 	void OnJoinSessionComplete(FName SessionName, EOnJoinSessionCompleteResult::Type Result);
 
 	FName MySessionName;
+
+	// Session settings, set in DefaultGame.ini under [/Script/CoopAdventure.MultiplayerSessionsSubsystem]
+	UPROPERTY(Config)
+	int32 NumPublicConnections;
+
+	// Search for dedicated server sessions instead of presence lobbies
+	UPROPERTY(Config)
+	bool SearchDedicatedServers;
+
+	// Used by dedicated servers when -ServerName= isn't on the command line
+	UPROPERTY(Config)
+	FString DedicatedServerName;
 	bool CreateServerAfterDestroy;
 	FString DestroyServerName;
 	FString ServerNameToFind;
 
 	TSharedPtr<FOnlineSessionSearch> SessionSearch;
 
+	// SERVER_NAME -> index into SessionSearch->SearchResults, rebuilt for each search
+	TMap<FString, int32> SearchResultIndexByName;
+
+	struct FCachedSession
+	{
+		FOnlineSessionSearchResult Result;
+		// Resolved when cached so joining doesn't have to wait for it
+		FString ConnectString;
+		double CacheTime = 0.0;
+	};
+
+	// SERVER_NAME -> last seen session
+	TMap<FString, FCachedSession> SessionBrowserCache;
+	TSharedPtr<FOnlineSessionSearch> BrowserSearch;
+	FTimerHandle SessionBrowserTimer;
+
+	bool BrowserRefreshInFlight;
+	bool FindServerInFlight;
+	bool FindServerAfterRefresh;
+	bool JoiningFromCache;
+	FString PendingConnectString;
+	double JoinRequestTime;
+
+	// Seconds between background session browser searches while in the menu, 0 disables the browser
+	UPROPERTY(Config, BlueprintReadWrite)
+	float SessionBrowserRefreshInterval;
+
+	// Cached sessions older than this are searched for again instead of joined directly
+	UPROPERTY(Config, BlueprintReadWrite)
+	float SessionBrowserMaxCacheAge;
+
 	UPROPERTY(BlueprintAssignable)
 	FServerCreateDelegate ServerCreateDel;
 
@@ -54,4 +127,19 @@ public:
 
 	UPROPERTY(BlueprintReadWrite)
 	FString GameMapPath;
+
+	// Kept referenced until the travel finishes so the preloaded map isn't collected
+	UPROPERTY()
+	TObjectPtr<UPackage> PreloadedMapPackage;
+
+	bool HostStartupInProgress;
+	bool MapPreloadInFlight;
+	bool SessionReadyForTravel;
+	bool TravelIsSeamless;
+
+	// FPlatformTime::Seconds() at each host startup stage, for the timing report
+	double HostStartTime;
+	double SessionCreatedTime;
+	double MapPreloadedTime;
+	double TravelStartTime;
 };
@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NetRelevancyPolicyComponent.h"
+#include "PuzzleRoomVolume.h"
+
+UNetRelevancyPolicyComponent::UNetRelevancyPolicyComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	NetCullDistance = 0.0f;
+	NetUpdateFrequency = 0.0f;
+	MinNetUpdateFrequency = 0.0f;
+	NetPriority = 0.0f;
+	bRelevantOnlyInSameRoom = false;
+}
+
+void UNetRelevancyPolicyComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	AActor* Owner = GetOwner();
+	if (!Owner->HasAuthority())
+	{
+		return;
+	}
+
+	if (NetCullDistance > 0.0f)
+	{
+		Owner->NetCullDistanceSquared = FMath::Square(NetCullDistance);
+	}
+	if (NetUpdateFrequency > 0.0f)
+	{
+		Owner->NetUpdateFrequency = NetUpdateFrequency;
+	}
+	if (MinNetUpdateFrequency > 0.0f)
+	{
+		Owner->MinNetUpdateFrequency = MinNetUpdateFrequency;
+	}
+	if (NetPriority > 0.0f)
+	{
+		Owner->NetPriority = NetPriority;
+	}
+
+	if (bRelevantOnlyInSameRoom && RoomName.IsNone())
+	{
+		if (UPuzzleRoomSubsystem* RoomSubsystem = GetWorld()->GetSubsystem<UPuzzleRoomSubsystem>())
+		{
+			RoomName = RoomSubsystem->FindRoomAt(Owner->GetActorLocation());
+		}
+	}
+}
+
+bool UNetRelevancyPolicyComponent::IsRelevantFor(const AActor* RealViewer, const AActor* ViewTarget) const
+{
+	if (!bRelevantOnlyInSameRoom || RoomName.IsNone())
+	{
+		return true;
+	}
+
+	UPuzzleRoomSubsystem* RoomSubsystem = GetWorld()->GetSubsystem<UPuzzleRoomSubsystem>();
+	if (!RoomSubsystem)
+	{
+		return true;
+	}
+
+	return RoomSubsystem->FindViewerRoom(ViewTarget ? ViewTarget : RealViewer) == RoomName;
+}
@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "NetRelevancyPolicyComponent.generated.h"
+
+/**
+ * Per-class network relevancy and priority settings for puzzle actors.
+ * Applies cull distance, update frequency and priority to the owner when play begins,
+ * and optionally limits relevancy to players standing in the owner's puzzle room.
+ * The replication graph reads the same settings when the owner is routed, so actors spawned
+ * at runtime must get the component before SetReplicates(true). The room is looked up in
+ * BeginPlay, which relies on UPuzzleRoomSubsystem registering the level's rooms in OnWorldBeginPlay.
+ * Without the graph, owners call IsRelevantFor from their IsNetRelevantFor override.
+ */
+UCLASS(ClassGroup = (Network), meta = (BlueprintSpawnableComponent))
+class COOPADVENTURE_API UNetRelevancyPolicyComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UNetRelevancyPolicyComponent();
+
+	bool IsRelevantFor(const AActor* RealViewer, const AActor* ViewTarget) const;
+
+	// Beyond this distance the owner isn't relevant; 0 keeps the owner's own setting
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Relevancy)
+	float NetCullDistance;
+
+	// 0 keeps the owner's own setting
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Relevancy)
+	float NetUpdateFrequency;
+
+	// 0 keeps the owner's own setting
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Relevancy)
+	float MinNetUpdateFrequency;
+
+	// 0 keeps the owner's own setting
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Relevancy)
+	float NetPriority;
+
+	// Only relevant to players in the same puzzle room, when the owner is inside one
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Relevancy)
+	bool bRelevantOnlyInSameRoom;
+
+	// Room the owner belongs to; found from the APuzzleRoomVolume around it when left empty
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Relevancy)
+	FName RoomName;
+
+protected:
+	virtual void BeginPlay() override;
+};
@@ -2,24 +2,34 @@
 
 
 #include "PressurePlate.h"
+#include "CoopAdventure.h"
+#include "PressurePlateSubsystem.h"
+
+DECLARE_CYCLE_STAT(TEXT("PressurePlate Overlap Event"), STAT_PressurePlateOverlapEvent, STATGROUP_CoopAdventure);
+
+static const FName TriggerActorTag("TriggerActor");
 
 // Sets default values
 APressurePlate::APressurePlate()
 {
- 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+ 	// Occupancy is tracked through overlap events, so the plate never needs to tick.
+	PrimaryActorTick.bCanEverTick = false;
 
+	// Plates never move and their state is replicated through the APuzzleStateReplicator of
+	// their room, so the actor only replicates to stay net-addressable and is otherwise dormant.
 	bReplicates = true;
-	SetReplicateMovement(true);
+	NetDormancy = DORM_Initial;
 	
 	Activated = false;
+	OccupantCount = 0;
+	PlateIndex = INDEX_NONE;
 
 	RootComp = CreateDefaultSubobject<USceneComponent>(TEXT("Root Component"));
 	SetRootComponent(RootComp);
 
 	TriggerMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("Trigger Mesh"));
 	TriggerMesh->SetupAttachment(RootComp);
-	TriggerMesh->SetIsReplicated(true);
+	TriggerMesh->SetGenerateOverlapEvents(true);
 
 	auto TriggerMeshAsset = ConstructorHelpers::FObjectFinder<UStaticMesh>(
 		TEXT("/Game/StarterContent/Shapes/Shape_Cylinder"));
@@ -32,7 +42,6 @@ APressurePlate::APressurePlate()
 
 	Mesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("Mesh"));
 	Mesh->SetupAttachment(RootComp);
-	Mesh->SetIsReplicated(true);
 
 	auto MeshAsset = ConstructorHelpers::FObjectFinder<UStaticMesh>(
 		TEXT("/Game/PolygonPrototype/Meshes/FX/SM_FX_Glow_Ring_01"));
@@ -50,49 +59,104 @@ void APressurePlate::BeginPlay()
 	Super::BeginPlay();
 
 	TriggerMesh->SetVisibility(false);
+
+	if (HasAuthority() && UPressurePlateSubsystem::IsBatchedModeEnabled())
+	{
+		// The subsystem tests trigger actors against the plate bounds itself,
+		// so the trigger mesh doesn't need to take part in overlap queries.
+		TriggerMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		TriggerMesh->SetGenerateOverlapEvents(false);
+
+		if (UPressurePlateSubsystem* PlateSubsystem = GetWorld()->GetSubsystem<UPressurePlateSubsystem>())
+		{
+			PlateSubsystem->RegisterPlate(this);
+		}
+		return;
+	}
+
+	if (HasAuthority())
+	{
+		// Bind before switching the profile so actors already standing on the plate
+		// are reported by the overlap update that the profile change triggers.
+		TriggerMesh->OnComponentBeginOverlap.AddDynamic(this, &APressurePlate::OnTriggerBeginOverlap);
+		TriggerMesh->OnComponentEndOverlap.AddDynamic(this, &APressurePlate::OnTriggerEndOverlap);
+	}
+
 	TriggerMesh->SetCollisionProfileName(FName("OverlapAll"));
 }
 
-// Called every frame
-void APressurePlate::Tick(float DeltaTime)
+void APressurePlate::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	Super::Tick(DeltaTime);
-
-	if (HasAuthority())
+	if (UPressurePlateSubsystem* PlateSubsystem = GetWorld()->GetSubsystem<UPressurePlateSubsystem>())
 	{
-		AActor* TriggerActor = 0;
-		TArray<AActor*> OverlappingActors;
-		TriggerMesh->GetOverlappingActors(OverlappingActors);
-		for (int ActorIdx = 0; ActorIdx < OverlappingActors.Num(); ++ActorIdx)
-		{
-			AActor* A = OverlappingActors[ActorIdx];
-			if (A->ActorHasTag("TriggerActor"))
-			{
-				TriggerActor = A;
-				break;
-			}
-
-			//FString Msg = FString::Printf(TEXT("Name: %s"), *A->GetName());
-			//GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::White, Msg);
-		}
+		PlateSubsystem->UnregisterPlate(this);
 
-		if (TriggerActor)
-		{
-			if (!Activated)
-			{
-				Activated = true;
-				GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::White, TEXT("Activated"));
-			}
-		}
-		else
+		if (HasAuthority())
 		{
-			if (Activated)
-			{
-				Activated = false;
-				GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::White, TEXT("Deactivated"));
-			}
+			PlateSubsystem->RemovePlateState(this);
 		}
 	}
 
+	Super::EndPlay(EndPlayReason);
+}
+
+void APressurePlate::OnTriggerBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
+	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PressurePlateOverlapEvent);
+
+	if (OtherActor && OtherActor->ActorHasTag(TriggerActorTag))
+	{
+		++OccupantCount;
+		SetActivated(true);
+	}
 }
 
+void APressurePlate::OnTriggerEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
+	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PressurePlateOverlapEvent);
+
+	if (OtherActor && OtherActor->ActorHasTag(TriggerActorTag))
+	{
+		OccupantCount = FMath::Max(OccupantCount - 1, 0);
+		SetActivated(OccupantCount > 0);
+	}
+}
+
+void APressurePlate::SetOccupantCount(int32 NewOccupantCount)
+{
+	OccupantCount = NewOccupantCount;
+	SetActivated(OccupantCount > 0);
+}
+
+void APressurePlate::SetActivated(bool bNewActivated)
+{
+	if (Activated == bNewActivated)
+	{
+		return;
+	}
+
+	Activated = bNewActivated;
+#if !UE_SERVER
+	GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::White, Activated ? TEXT("Activated") : TEXT("Deactivated"));
+#endif
+
+	if (UPressurePlateSubsystem* PlateSubsystem = GetWorld()->GetSubsystem<UPressurePlateSubsystem>())
+	{
+		PlateSubsystem->SetPlateStateReplicated(this, Activated);
+	}
+
+	OnActivationChanged.Broadcast(Activated);
+}
+
+void APressurePlate::OnRep_Activated(bool bNewActivated)
+{
+	if (Activated == bNewActivated)
+	{
+		return;
+	}
+
+	Activated = bNewActivated;
+	OnActivationChanged.Broadcast(Activated);
+}
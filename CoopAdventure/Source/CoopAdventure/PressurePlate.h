@@ -7,6 +7,8 @@
 #include "Components/StaticMeshComponent.h"
 #include "PressurePlate.generated.h"
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FPlateActivationChangedDelegate, bool, bActivated);
+
 UCLASS()
 class COOPADVENTURE_API APressurePlate : public AActor
 {
@@ -20,9 +22,29 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Overlap events from TriggerMesh, only bound on the server
+	UFUNCTION()
+	void OnTriggerBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
+		UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
+	UFUNCTION()
+	void OnTriggerEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
+		UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
+
+	void SetActivated(bool bNewActivated);
+
 public:	
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
+	// Called by UPressurePlateSubsystem when the batched pass sees a new occupancy
+	void SetOccupantCount(int32 NewOccupantCount);
+
+	// Called on clients by APuzzleStateReplicator when the plate's state arrives
+	void OnRep_Activated(bool bNewActivated);
+
+	// Fired on the server and on clients whenever Activated changes
+	UPROPERTY(BlueprintAssignable)
+	FPlateActivationChangedDelegate OnActivationChanged;
 
 	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
 	USceneComponent* RootComp;
@@ -36,4 +58,11 @@ public:
 	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
 	bool Activated;
 
+	// Number of TriggerActor components currently overlapping TriggerMesh
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere)
+	int32 OccupantCount;
+
+	// Slot in UPressurePlateSubsystem, INDEX_NONE when the plate uses its own overlap events
+	int32 PlateIndex;
+
 };
@@ -0,0 +1,424 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PressurePlateSubsystem.h"
+#include "CoopAdventure.h"
+#include "PressurePlate.h"
+#include "PuzzleRoomVolume.h"
+#include "PuzzleStateReplicator.h"
+#include "EngineUtils.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("PressurePlate Batched Update"), STAT_PressurePlateBatchedUpdate, STATGROUP_CoopAdventure);
+DECLARE_DWORD_COUNTER_STAT(TEXT("PressurePlates Batched"), STAT_PressurePlatesBatched, STATGROUP_CoopAdventure);
+DECLARE_DWORD_COUNTER_STAT(TEXT("PressurePlate Trigger Actors"), STAT_PressurePlateTriggerActors, STATGROUP_CoopAdventure);
+
+static TAutoConsoleVariable<bool> CVarPressurePlateBatched(
+	TEXT("CoopAdventure.PressurePlate.Batched"),
+	true,
+	TEXT("If true, pressure plates spawned after this is set are evaluated by UPressurePlateSubsystem in one batched pass per server frame.\n")
+	TEXT("If false, each plate tracks occupancy with its own overlap events."));
+
+static const FName TriggerActorTag("TriggerActor");
+
+bool UPressurePlateSubsystem::IsBatchedModeEnabled()
+{
+	return CVarPressurePlateBatched.GetValueOnGameThread();
+}
+
+bool UPressurePlateSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UPressurePlateSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (InWorld.GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	for (TActorIterator<AActor> It(&InWorld); It; ++It)
+	{
+		AddTriggerActor(*It);
+	}
+
+	ActorSpawnedHandle = InWorld.AddOnActorSpawnedHandler(
+		FOnActorSpawned::FDelegate::CreateUObject(this, &UPressurePlateSubsystem::OnActorSpawned));
+}
+
+void UPressurePlateSubsystem::Deinitialize()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	}
+
+	Super::Deinitialize();
+}
+
+bool UPressurePlateSubsystem::IsTickable() const
+{
+	return NumRegisteredPlates > 0;
+}
+
+TStatId UPressurePlateSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPressurePlateSubsystem, STATGROUP_Tickables);
+}
+
+void UPressurePlateSubsystem::RegisterPlate(APressurePlate* Plate)
+{
+	if (!Plate || Plate->PlateIndex != INDEX_NONE)
+	{
+		return;
+	}
+
+	const FBoxSphereBounds& Bounds = Plate->TriggerMesh->Bounds;
+	FPlateVolume Volume;
+	Volume.Center = Bounds.Origin;
+	Volume.RadiusSquared = FMath::Square(FMath::Max(Bounds.BoxExtent.X, Bounds.BoxExtent.Y));
+	Volume.HalfHeight = Bounds.BoxExtent.Z;
+
+	int32 Index;
+	if (FreeIndices.Num() > 0)
+	{
+		Index = FreeIndices.Pop(false);
+		Plates[Index] = Plate;
+		Volumes[Index] = Volume;
+		OccupantCounts[Index] = 0;
+	}
+	else
+	{
+		Index = Plates.Add(Plate);
+		Volumes.Add(Volume);
+		OccupantCounts.Add(0);
+		NewOccupantCounts.Add(0);
+		VisitStamps.Add(0);
+	}
+	Plate->PlateIndex = Index;
+	++NumRegisteredPlates;
+
+	const FIntPoint MinCell = GetCell(Bounds.Origin - Bounds.BoxExtent);
+	const FIntPoint MaxCell = GetCell(Bounds.Origin + Bounds.BoxExtent);
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			Grid.FindOrAdd(FIntPoint(X, Y)).Add(Index);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_PressurePlatesBatched, NumRegisteredPlates);
+}
+
+void UPressurePlateSubsystem::UnregisterPlate(APressurePlate* Plate)
+{
+	if (!Plate || !Plates.IsValidIndex(Plate->PlateIndex) || Plates[Plate->PlateIndex] != Plate)
+	{
+		return;
+	}
+
+	const int32 Index = Plate->PlateIndex;
+	const FPlateVolume& Volume = Volumes[Index];
+	const float Radius = FMath::Sqrt(Volume.RadiusSquared);
+	const FIntPoint MinCell = GetCell(Volume.Center - FVector(Radius, Radius, 0.0f));
+	const FIntPoint MaxCell = GetCell(Volume.Center + FVector(Radius, Radius, 0.0f));
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			if (TArray<int32>* Cell = Grid.Find(FIntPoint(X, Y)))
+			{
+				Cell->RemoveSwap(Index, false);
+				if (Cell->Num() == 0)
+				{
+					Grid.Remove(FIntPoint(X, Y));
+				}
+			}
+		}
+	}
+
+	Plates[Index] = nullptr;
+	OccupantCounts[Index] = 0;
+	FreeIndices.Add(Index);
+	Plate->PlateIndex = INDEX_NONE;
+	--NumRegisteredPlates;
+
+	SET_DWORD_STAT(STAT_PressurePlatesBatched, NumRegisteredPlates);
+}
+
+void UPressurePlateSubsystem::SetPlateStateReplicated(APressurePlate* Plate, bool bActivated)
+{
+	if (APuzzleStateReplicator* PuzzleStateReplicator = FindPuzzleStateReplicator(Plate, true))
+	{
+		PuzzleStateReplicator->SetPlateActivated(Plate, bActivated);
+	}
+}
+
+void UPressurePlateSubsystem::RemovePlateState(APressurePlate* Plate)
+{
+	if (APuzzleStateReplicator* PuzzleStateReplicator = FindPuzzleStateReplicator(Plate, false))
+	{
+		PuzzleStateReplicator->RemovePlate(Plate);
+	}
+}
+
+int32 UPressurePlateSubsystem::GetNumPlateStates(FName RoomName) const
+{
+	const TObjectPtr<APuzzleStateReplicator>* PuzzleStateReplicator = PuzzleStateReplicators.Find(RoomName);
+	return PuzzleStateReplicator && *PuzzleStateReplicator ? (*PuzzleStateReplicator)->GetNumPlateStates() : 0;
+}
+
+APuzzleStateReplicator* UPressurePlateSubsystem::FindPuzzleStateReplicator(const APressurePlate* Plate, bool bCreateIfMissing)
+{
+	UWorld* World = GetWorld();
+	if (!Plate || !World || World->GetNetMode() == NM_Client)
+	{
+		return nullptr;
+	}
+
+	// Plates never move, so a plate finds the same room every time it asks
+	const UPuzzleRoomSubsystem* RoomSubsystem = World->GetSubsystem<UPuzzleRoomSubsystem>();
+	const FName RoomName = RoomSubsystem ? RoomSubsystem->FindRoomAt(Plate->GetActorLocation()) : NAME_None;
+
+	if (const TObjectPtr<APuzzleStateReplicator>* PuzzleStateReplicator = PuzzleStateReplicators.Find(RoomName))
+	{
+		return *PuzzleStateReplicator;
+	}
+
+	if (!bCreateIfMissing)
+	{
+		return nullptr;
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.ObjectFlags |= RF_Transient;
+	SpawnParameters.bDeferConstruction = true;
+	APuzzleStateReplicator* PuzzleStateReplicator = World->SpawnActor<APuzzleStateReplicator>(SpawnParameters);
+	if (PuzzleStateReplicator)
+	{
+		PuzzleStateReplicator->SetRoomName(RoomName);
+		PuzzleStateReplicator->FinishSpawning(FTransform::Identity);
+		PuzzleStateReplicators.Add(RoomName, PuzzleStateReplicator);
+	}
+	return PuzzleStateReplicator;
+}
+
+void UPressurePlateSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PressurePlateBatchedUpdate);
+
+	FMemory::Memzero(NewOccupantCounts.GetData(), NewOccupantCounts.Num() * sizeof(int32));
+
+	for (int32 ActorIdx = TriggerActors.Num() - 1; ActorIdx >= 0; --ActorIdx)
+	{
+		AActor* TriggerActor = TriggerActors[ActorIdx].Get();
+		if (!TriggerActor || !TriggerActor->GetRootComponent())
+		{
+			TriggerActors.RemoveAtSwap(ActorIdx, 1, false);
+			continue;
+		}
+
+		// One stamp per trigger actor so a plate spanning several cells is counted once
+		++CurrentStamp;
+
+		const FBox ActorBox = TriggerActor->GetRootComponent()->Bounds.GetBox();
+		const FIntPoint MinCell = GetCell(ActorBox.Min);
+		const FIntPoint MaxCell = GetCell(ActorBox.Max);
+		for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+		{
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+			{
+				const TArray<int32>* Cell = Grid.Find(FIntPoint(X, Y));
+				if (!Cell)
+				{
+					continue;
+				}
+
+				for (const int32 Index : *Cell)
+				{
+					if (VisitStamps[Index] == CurrentStamp)
+					{
+						continue;
+					}
+					VisitStamps[Index] = CurrentStamp;
+
+					const FPlateVolume& Volume = Volumes[Index];
+					if (ActorBox.Min.Z > Volume.Center.Z + Volume.HalfHeight
+						|| ActorBox.Max.Z < Volume.Center.Z - Volume.HalfHeight)
+					{
+						continue;
+					}
+
+					const float ClosestX = FMath::Clamp(Volume.Center.X, ActorBox.Min.X, ActorBox.Max.X);
+					const float ClosestY = FMath::Clamp(Volume.Center.Y, ActorBox.Min.Y, ActorBox.Max.Y);
+					const float DistSquared = FMath::Square(ClosestX - Volume.Center.X) + FMath::Square(ClosestY - Volume.Center.Y);
+					if (DistSquared <= Volume.RadiusSquared)
+					{
+						++NewOccupantCounts[Index];
+					}
+				}
+			}
+		}
+	}
+
+	SET_DWORD_STAT(STAT_PressurePlateTriggerActors, TriggerActors.Num());
+
+	// Only plates whose occupancy changed are touched
+	for (int32 Index = 0; Index < OccupantCounts.Num(); ++Index)
+	{
+		if (OccupantCounts[Index] != NewOccupantCounts[Index] && Plates[Index])
+		{
+			OccupantCounts[Index] = NewOccupantCounts[Index];
+			Plates[Index]->SetOccupantCount(OccupantCounts[Index]);
+		}
+	}
+}
+
+void UPressurePlateSubsystem::AddTriggerActor(AActor* Actor)
+{
+	if (Actor && Actor->ActorHasTag(TriggerActorTag))
+	{
+		TriggerActors.AddUnique(Actor);
+	}
+}
+
+void UPressurePlateSubsystem::OnActorSpawned(AActor* Actor)
+{
+	AddTriggerActor(Actor);
+}
+
+FIntPoint UPressurePlateSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+static void RunPlateBenchmark(UWorld* World, int32 NumPlates, bool bBatched)
+{
+	UPressurePlateSubsystem* PlateSubsystem = World->GetSubsystem<UPressurePlateSubsystem>();
+	UStaticMesh* CubeMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	if (!PlateSubsystem || !CubeMesh)
+	{
+		return;
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParameters.ObjectFlags |= RF_Transient;
+
+	// Plates pick their mode in BeginPlay. They go far below the level so its own trigger actors never reach them
+	const bool bWasBatched = CVarPressurePlateBatched.GetValueOnGameThread();
+	CVarPressurePlateBatched->Set(bBatched, ECVF_SetByConsole);
+
+	const FVector Origin(0.0f, 0.0f, -100000.0f);
+	const int32 Columns = FMath::CeilToInt(FMath::Sqrt((float)NumPlates));
+	TArray<APressurePlate*> BenchmarkPlates;
+	for (int32 Index = 0; Index < NumPlates; ++Index)
+	{
+		const FVector Location = Origin + FVector((Index % Columns) * 400.0f, (Index / Columns) * 400.0f, 0.0f);
+		if (APressurePlate* Plate = World->SpawnActor<APressurePlate>(Location, FRotator::ZeroRotator, SpawnParameters))
+		{
+			BenchmarkPlates.Add(Plate);
+		}
+	}
+
+	CVarPressurePlateBatched->Set(bWasBatched, ECVF_SetByConsole);
+
+	// Same trigger actors for both modes, tagged after spawning so they're added by hand
+	constexpr int32 NumTriggerActors = 32;
+	TArray<AStaticMeshActor*> TriggerActors;
+	for (int32 Index = 0; Index < NumTriggerActors; ++Index)
+	{
+		AStaticMeshActor* TriggerActor = World->SpawnActor<AStaticMeshActor>(Origin, FRotator::ZeroRotator, SpawnParameters);
+		if (!TriggerActor)
+		{
+			continue;
+		}
+
+		TriggerActor->SetMobility(EComponentMobility::Movable);
+		TriggerActor->GetStaticMeshComponent()->SetStaticMesh(CubeMesh);
+		TriggerActor->GetStaticMeshComponent()->SetCollisionProfileName(FName("OverlapAllDynamic"));
+		TriggerActor->GetStaticMeshComponent()->SetGenerateOverlapEvents(true);
+		TriggerActor->SetActorScale3D(FVector(0.5f));
+		TriggerActor->Tags.Add(TriggerActorTag);
+		PlateSubsystem->AddTriggerActor(TriggerActor);
+		TriggerActors.Add(TriggerActor);
+	}
+
+	// Each step every trigger actor either lands on a random plate or between plates. The per-actor
+	// path pays in the overlap updates of the moves, the batched one in the subsystem's pass
+	constexpr int32 NumSteps = 100;
+	FRandomStream Random(NumPlates);
+	double MoveSeconds = 0.0;
+	double BatchedSeconds = 0.0;
+	for (int32 Step = 0; Step < NumSteps && BenchmarkPlates.Num() > 0; ++Step)
+	{
+		double StartTime = FPlatformTime::Seconds();
+		for (AStaticMeshActor* TriggerActor : TriggerActors)
+		{
+			const FVector Offset = Random.FRand() < 0.5f ? FVector(0.0f, 0.0f, 20.0f) : FVector(200.0f, 200.0f, 20.0f);
+			TriggerActor->SetActorLocation(BenchmarkPlates[Random.RandHelper(BenchmarkPlates.Num())]->GetActorLocation() + Offset);
+		}
+		MoveSeconds += FPlatformTime::Seconds() - StartTime;
+
+		if (bBatched)
+		{
+			StartTime = FPlatformTime::Seconds();
+			PlateSubsystem->Tick(0.0f);
+			BatchedSeconds += FPlatformTime::Seconds() - StartTime;
+		}
+	}
+
+	int32 NumActivated = 0;
+	for (const APressurePlate* Plate : BenchmarkPlates)
+	{
+		NumActivated += Plate->Activated ? 1 : 0;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Plate benchmark, %d plates, %s: %.3f ms per step moving %d trigger actors, %.3f ms per step in the batched pass, %d activated after the last step"),
+		BenchmarkPlates.Num(), bBatched ? TEXT("batched") : TEXT("per-actor"), MoveSeconds * 1000.0 / NumSteps,
+		TriggerActors.Num(), BatchedSeconds * 1000.0 / NumSteps, NumActivated);
+
+	for (AStaticMeshActor* TriggerActor : TriggerActors)
+	{
+		TriggerActor->Destroy();
+	}
+	for (APressurePlate* Plate : BenchmarkPlates)
+	{
+		Plate->Destroy();
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs PressurePlateBenchmarkCommand(
+	TEXT("CoopAdventure.PressurePlate.Benchmark"),
+	TEXT("Times per-actor and batched pressure plates with the same trigger actors moving across them. Takes plate counts, defaults to 10 100 1000 10000.\n")
+	TEXT("Run on the server or in standalone."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World || World->GetNetMode() == NM_Client)
+		{
+			return;
+		}
+
+		TArray<int32> PlateCounts = { 10, 100, 1000, 10000 };
+		if (Args.Num() > 0)
+		{
+			PlateCounts.Reset();
+			for (const FString& Arg : Args)
+			{
+				PlateCounts.Add(FMath::Max(FCString::Atoi(*Arg), 1));
+			}
+		}
+
+		for (const int32 NumPlates : PlateCounts)
+		{
+			RunPlateBenchmark(World, NumPlates, false);
+			RunPlateBenchmark(World, NumPlates, true);
+		}
+	}));
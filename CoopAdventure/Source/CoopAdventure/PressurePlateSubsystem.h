@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PressurePlateSubsystem.generated.h"
+
+class APressurePlate;
+class APuzzleStateReplicator;
+
+/**
+ * Server-side batched evaluation of every pressure plate in the world.
+ * Plate trigger volumes live in one flat array bucketed by a uniform XY grid,
+ * and each frame the TriggerActors are tested against only the cells they touch.
+ */
+UCLASS()
+class COOPADVENTURE_API UPressurePlateSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Whether new plates should register here instead of binding their own overlap events
+	static bool IsBatchedModeEnabled();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterPlate(APressurePlate* Plate);
+	void UnregisterPlate(APressurePlate* Plate);
+
+	// Server only, forwards a plate's activation state to the puzzle state replicator of its room
+	void SetPlateStateReplicated(APressurePlate* Plate, bool bActivated);
+	void RemovePlateState(APressurePlate* Plate);
+
+	// Plate entries replicated to players standing in RoomName, NAME_None for plates outside every room
+	int32 GetNumPlateStates(FName RoomName) const;
+
+	// Actors are only picked up on their own if they have the TriggerActor tag when play begins or when
+	// they spawn; actors tagged later have to be added here. Per-actor plates check the tag on every overlap.
+	void AddTriggerActor(AActor* Actor);
+
+private:
+	// Trigger volume of a plate, approximated by an upright cylinder
+	struct FPlateVolume
+	{
+		FVector Center;
+		float RadiusSquared;
+		float HalfHeight;
+	};
+
+	void OnActorSpawned(AActor* Actor);
+
+	// Replicators are spawned on a room's first plate change, so rooms registered during BeginPlay are known by then
+	APuzzleStateReplicator* FindPuzzleStateReplicator(const APressurePlate* Plate, bool bCreateIfMissing);
+
+	FIntPoint GetCell(const FVector& Location) const;
+
+	// Indexed by APressurePlate::PlateIndex; unregistered slots are null and recycled
+	UPROPERTY()
+	TArray<TObjectPtr<APressurePlate>> Plates;
+
+	TArray<FPlateVolume> Volumes;
+	TArray<int32> OccupantCounts;
+	TArray<int32> FreeIndices;
+
+	// Scratch buffers reused every frame
+	TArray<int32> NewOccupantCounts;
+	TArray<uint32> VisitStamps;
+	uint32 CurrentStamp = 0;
+
+	TMap<FIntPoint, TArray<int32>> Grid;
+	float CellSize = 500.0f;
+
+	// Keyed by APuzzleRoomVolume::RoomName
+	UPROPERTY()
+	TMap<FName, TObjectPtr<APuzzleStateReplicator>> PuzzleStateReplicators;
+
+	TArray<TWeakObjectPtr<AActor>> TriggerActors;
+	FDelegateHandle ActorSpawnedHandle;
+
+	int32 NumRegisteredPlates = 0;
+};
@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PuzzleRoomVolume.h"
+#include "Components/BrushComponent.h"
+#include "EngineUtils.h"
+
+APuzzleRoomVolume::APuzzleRoomVolume()
+{
+	GetBrushComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	GetBrushComponent()->SetGenerateOverlapEvents(false);
+}
+
+void APuzzleRoomVolume::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UPuzzleRoomSubsystem* RoomSubsystem = GetWorld()->GetSubsystem<UPuzzleRoomSubsystem>())
+	{
+		RoomSubsystem->RegisterRoom(this);
+	}
+}
+
+void APuzzleRoomVolume::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UPuzzleRoomSubsystem* RoomSubsystem = GetWorld()->GetSubsystem<UPuzzleRoomSubsystem>())
+	{
+		RoomSubsystem->UnregisterRoom(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+bool UPuzzleRoomSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UPuzzleRoomSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	for (TActorIterator<APuzzleRoomVolume> It(&InWorld); It; ++It)
+	{
+		RegisterRoom(*It);
+	}
+}
+
+void UPuzzleRoomSubsystem::RegisterRoom(APuzzleRoomVolume* Room)
+{
+	Rooms.AddUnique(Room);
+	ViewerRoomCache.Reset();
+}
+
+void UPuzzleRoomSubsystem::UnregisterRoom(APuzzleRoomVolume* Room)
+{
+	Rooms.Remove(Room);
+	ViewerRoomCache.Reset();
+}
+
+FName UPuzzleRoomSubsystem::FindRoomAt(const FVector& Location) const
+{
+	for (const APuzzleRoomVolume* Room : Rooms)
+	{
+		if (Room && Room->EncompassesPoint(Location))
+		{
+			return Room->RoomName;
+		}
+	}
+
+	return NAME_None;
+}
+
+FName UPuzzleRoomSubsystem::FindViewerRoom(const AActor* Viewer)
+{
+	if (!Viewer)
+	{
+		return NAME_None;
+	}
+
+	if (ViewerRoomCacheFrame != GFrameCounter)
+	{
+		ViewerRoomCache.Reset();
+		ViewerRoomCacheFrame = GFrameCounter;
+	}
+
+	if (const FName* CachedRoom = ViewerRoomCache.Find(Viewer))
+	{
+		return *CachedRoom;
+	}
+
+	return ViewerRoomCache.Add(Viewer, FindRoomAt(Viewer->GetActorLocation()));
+}
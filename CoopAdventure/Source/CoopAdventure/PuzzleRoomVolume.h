@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Volume.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PuzzleRoomVolume.generated.h"
+
+/**
+ * Marks the extent of one puzzle room. Puzzle actors with a UNetRelevancyPolicyComponent
+ * can be limited to players standing in the same room.
+ */
+UCLASS()
+class COOPADVENTURE_API APuzzleRoomVolume : public AVolume
+{
+	GENERATED_BODY()
+
+public:
+	APuzzleRoomVolume();
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = PuzzleRoom)
+	FName RoomName;
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+};
+
+/**
+ * Keeps track of the puzzle rooms in the world and answers "which room is this point in",
+ * caching the answer for viewers during a frame since relevancy asks once per actor per connection.
+ */
+UCLASS()
+class COOPADVENTURE_API UPuzzleRoomSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	// Registers the rooms already in the level before any actor's BeginPlay looks them up
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	void RegisterRoom(APuzzleRoomVolume* Room);
+	void UnregisterRoom(APuzzleRoomVolume* Room);
+
+	// NAME_None when Location isn't inside any room
+	FName FindRoomAt(const FVector& Location) const;
+
+	// Same as FindRoomAt(Viewer->GetActorLocation()), cached for the current frame
+	FName FindViewerRoom(const AActor* Viewer);
+
+	bool HasRooms() const { return Rooms.Num() > 0; }
+
+private:
+	UPROPERTY()
+	TArray<TObjectPtr<APuzzleRoomVolume>> Rooms;
+
+	TMap<TObjectKey<AActor>, FName> ViewerRoomCache;
+	uint64 ViewerRoomCacheFrame = 0;
+};
@@ -0,0 +1,97 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PuzzleStateReplicator.h"
+#include "NetRelevancyPolicyComponent.h"
+#include "PressurePlate.h"
+#include "Net/UnrealNetwork.h"
+
+void FPuzzlePlateState::PostReplicatedAdd(const FPuzzlePlateStateArray& InArraySerializer)
+{
+	if (Plate)
+	{
+		Plate->OnRep_Activated(bActivated);
+	}
+}
+
+void FPuzzlePlateState::PostReplicatedChange(const FPuzzlePlateStateArray& InArraySerializer)
+{
+	if (Plate)
+	{
+		Plate->OnRep_Activated(bActivated);
+	}
+}
+
+APuzzleStateReplicator::APuzzleStateReplicator()
+{
+	bReplicates = true;
+	NetUpdateFrequency = 10.0f;
+
+	NetRelevancyPolicy = CreateDefaultSubobject<UNetRelevancyPolicyComponent>(TEXT("Net Relevancy Policy"));
+}
+
+void APuzzleStateReplicator::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(APuzzleStateReplicator, PlateStates);
+}
+
+bool APuzzleStateReplicator::IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const
+{
+	// The replicator has no meaningful location, so distance plays no part
+	return NetRelevancyPolicy->IsRelevantFor(RealViewer, ViewTarget);
+}
+
+void APuzzleStateReplicator::SetRoomName(FName InRoomName)
+{
+	NetRelevancyPolicy->RoomName = InRoomName;
+	NetRelevancyPolicy->bRelevantOnlyInSameRoom = !InRoomName.IsNone();
+}
+
+FName APuzzleStateReplicator::GetRoomName() const
+{
+	return NetRelevancyPolicy->bRelevantOnlyInSameRoom ? NetRelevancyPolicy->RoomName : NAME_None;
+}
+
+void APuzzleStateReplicator::SetPlateActivated(APressurePlate* Plate, bool bActivated)
+{
+	if (!Plate)
+	{
+		return;
+	}
+
+	if (const int32* Index = PlateStateIndices.Find(Plate))
+	{
+		FPuzzlePlateState& State = PlateStates.Items[*Index];
+		if (State.bActivated != bActivated)
+		{
+			State.bActivated = bActivated;
+			PlateStates.MarkItemDirty(State);
+		}
+		return;
+	}
+
+	// Clients assume plates start deactivated, so entries are only created on the first change
+	FPuzzlePlateState& State = PlateStates.Items.AddDefaulted_GetRef();
+	State.Plate = Plate;
+	State.bActivated = bActivated;
+	PlateStates.MarkItemDirty(State);
+	PlateStateIndices.Add(Plate, PlateStates.Items.Num() - 1);
+}
+
+void APuzzleStateReplicator::RemovePlate(APressurePlate* Plate)
+{
+	int32 Index;
+	if (!PlateStateIndices.RemoveAndCopyValue(Plate, Index))
+	{
+		return;
+	}
+
+	PlateStates.Items.RemoveAtSwap(Index, 1, false);
+	if (PlateStates.Items.IsValidIndex(Index))
+	{
+		PlateStateIndices.Add(PlateStates.Items[Index].Plate.Get(), Index);
+	}
+	PlateStates.MarkArrayDirty();
+}
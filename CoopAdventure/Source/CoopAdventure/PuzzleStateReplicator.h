@@ -0,0 +1,95 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "PuzzleStateReplicator.generated.h"
+
+class APressurePlate;
+class UNetRelevancyPolicyComponent;
+struct FPuzzlePlateStateArray;
+
+USTRUCT()
+struct FPuzzlePlateState : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	FPuzzlePlateState()
+		: bActivated(false)
+	{
+	}
+
+	UPROPERTY()
+	TObjectPtr<APressurePlate> Plate = nullptr;
+
+	UPROPERTY()
+	uint8 bActivated : 1;
+
+	void PostReplicatedAdd(const FPuzzlePlateStateArray& InArraySerializer);
+	void PostReplicatedChange(const FPuzzlePlateStateArray& InArraySerializer);
+};
+
+USTRUCT()
+struct FPuzzlePlateStateArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FPuzzlePlateState> Items;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FPuzzlePlateState, FPuzzlePlateStateArray>(Items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FPuzzlePlateStateArray> : public TStructOpsTypeTraitsBase2<FPuzzlePlateStateArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+/**
+ * Carries the state of the static puzzle pieces in one APuzzleRoomVolume, so it only
+ * replicates to players standing in that room; pieces outside every room share one that is
+ * relevant to everyone. Plates themselves stay dormant; only entries that changed are sent,
+ * so idle plates cost no bandwidth or property comparisons.
+ */
+UCLASS(NotPlaceable)
+class COOPADVENTURE_API APuzzleStateReplicator : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	APuzzleStateReplicator();
+
+	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	// Fallback for running without the replication graph, which never calls IsNetRelevantFor;
+	// with the graph, UCoopReplicationGraphNode_PuzzleRooms does the same room filtering
+	virtual bool IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const override;
+
+	// Server only, set before FinishSpawning so the policy doesn't look the room up from the actor's location
+	void SetRoomName(FName InRoomName);
+	FName GetRoomName() const;
+
+	// Server only
+	void SetPlateActivated(APressurePlate* Plate, bool bActivated);
+	void RemovePlate(APressurePlate* Plate);
+
+	int32 GetNumPlateStates() const { return PlateStates.Items.Num(); }
+
+	UPROPERTY(VisibleAnywhere)
+	TObjectPtr<UNetRelevancyPolicyComponent> NetRelevancyPolicy;
+
+private:
+	UPROPERTY(Replicated)
+	FPuzzlePlateStateArray PlateStates;
+
+	TMap<TObjectKey<APressurePlate>, int32> PlateStateIndices;
+};
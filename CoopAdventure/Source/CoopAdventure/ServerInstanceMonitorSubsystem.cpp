@@ -0,0 +1,132 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ServerInstanceMonitorSubsystem.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/FileHelper.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Engine/Engine.h"
+
+UServerInstanceMonitorSubsystem::UServerInstanceMonitorSubsystem()
+{
+	MemoryBudgetMB = 512;
+	FrameTimeBudgetMs = 33.3f;
+	ReportIntervalSeconds = 10.0f;
+	GarbageCollectionCooldownSeconds = 60.0f;
+
+	IntervalStartTime = 0.0;
+	NumFrames = 0;
+	TotalFrameTime = 0.0;
+	MaxFrameTime = 0.0;
+	NumFramesOverBudget = 0;
+
+	LastGarbageCollectionTime = -DBL_MAX;
+	UsedMBBeforeGarbageCollection = 0.0;
+	bCheckGarbageCollection = false;
+	NumIneffectiveGarbageCollections = 0;
+}
+
+bool UServerInstanceMonitorSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UServerInstanceMonitorSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Several instances share a host, so each needs its own id; the listen port is unique per instance
+	if (!FParse::Value(FCommandLine::Get(), TEXT("InstanceId="), InstanceId))
+	{
+		int32 Port = 7777;
+		FParse::Value(FCommandLine::Get(), TEXT("Port="), Port);
+		InstanceId = FString::FromInt(Port);
+	}
+
+	ReportPath = FPaths::ProfilingDir() / FString::Printf(TEXT("ServerInstance_%s.csv"), *InstanceId);
+	FFileHelper::SaveStringToFile(TEXT("Time,UsedPhysicalMB,PeakUsedPhysicalMB,AvgFrameMs,MaxFrameMs,FramesOverBudget\n"), *ReportPath);
+
+	IntervalStartTime = FPlatformTime::Seconds();
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateUObject(this, &UServerInstanceMonitorSubsystem::Tick));
+}
+
+void UServerInstanceMonitorSubsystem::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+
+	Super::Deinitialize();
+}
+
+bool UServerInstanceMonitorSubsystem::Tick(float DeltaTime)
+{
+	++NumFrames;
+	TotalFrameTime += DeltaTime;
+	MaxFrameTime = FMath::Max(MaxFrameTime, (double)DeltaTime);
+	if (DeltaTime * 1000.0f > FrameTimeBudgetMs)
+	{
+		++NumFramesOverBudget;
+	}
+
+	if (FPlatformTime::Seconds() - IntervalStartTime >= ReportIntervalSeconds)
+	{
+		WriteReport();
+	}
+
+	return true;
+}
+
+void UServerInstanceMonitorSubsystem::WriteReport()
+{
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+	const double UsedMB = MemoryStats.UsedPhysical / (1024.0 * 1024.0);
+	const double PeakMB = MemoryStats.PeakUsedPhysical / (1024.0 * 1024.0);
+	const double AvgFrameMs = NumFrames > 0 ? TotalFrameTime * 1000.0 / NumFrames : 0.0;
+
+	const FString Line = FString::Printf(TEXT("%.1f,%.1f,%.1f,%.2f,%.2f,%d\n"),
+		FPlatformTime::Seconds() - GStartTime, UsedMB, PeakMB, AvgFrameMs, MaxFrameTime * 1000.0, NumFramesOverBudget);
+	FFileHelper::SaveStringToFile(Line, *ReportPath, FFileHelper::EEncodingOptions::AutoDetect,
+		&IFileManager::Get(), FILEWRITE_Append);
+
+	UE_LOG(LogTemp, Log, TEXT("Instance %s: %.1f MB resident (budget %d MB), %.2f ms avg / %.2f ms max frame, %d frames over budget"),
+		*InstanceId, UsedMB, MemoryBudgetMB, AvgFrameMs, MaxFrameTime * 1000.0, NumFramesOverBudget);
+
+	const bool bOverMemoryBudget = MemoryBudgetMB > 0 && UsedMB > MemoryBudgetMB;
+
+	if (bCheckGarbageCollection)
+	{
+		bCheckGarbageCollection = false;
+
+		if (bOverMemoryBudget)
+		{
+			// Collecting again won't help, the instance is holding on to live memory; the host has to act on it
+			++NumIneffectiveGarbageCollections;
+			UE_LOG(LogTemp, Error, TEXT("Instance %s is still over its memory budget after collecting garbage (%.1f MB -> %.1f MB, %d times in a row)"),
+				*InstanceId, UsedMBBeforeGarbageCollection, UsedMB, NumIneffectiveGarbageCollections);
+		}
+		else
+		{
+			NumIneffectiveGarbageCollections = 0;
+		}
+	}
+
+	// The cooldown keeps a full purge from running every report while memory stays high
+	if (bOverMemoryBudget && FPlatformTime::Seconds() - LastGarbageCollectionTime >= GarbageCollectionCooldownSeconds)
+	{
+		// Give memory back before the host has to start swapping or killing instances
+		UE_LOG(LogTemp, Warning, TEXT("Instance %s is over its memory budget, collecting garbage"), *InstanceId);
+		GEngine->ForceGarbageCollection(true);
+		GEngine->TrimMemory();
+
+		LastGarbageCollectionTime = FPlatformTime::Seconds();
+		UsedMBBeforeGarbageCollection = UsedMB;
+		bCheckGarbageCollection = true;
+	}
+
+	IntervalStartTime = FPlatformTime::Seconds();
+	NumFrames = 0;
+	TotalFrameTime = 0.0;
+	MaxFrameTime = 0.0;
+	NumFramesOverBudget = 0;
+}
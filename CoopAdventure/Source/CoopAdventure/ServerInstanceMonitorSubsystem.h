@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/Ticker.h"
+#include "ServerInstanceMonitorSubsystem.generated.h"
+
+/**
+ * Dedicated server only. Tracks this instance's resident memory and frame time against
+ * a per-instance budget, and appends a line per report interval to
+ * Saved/Profiling/ServerInstance_<InstanceId>.csv so many instances packed on one host
+ * can be compared.
+ */
+UCLASS(Config=Game)
+class COOPADVENTURE_API UServerInstanceMonitorSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UServerInstanceMonitorSubsystem();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	void Initialize(FSubsystemCollectionBase& Collection) override;
+	void Deinitialize() override;
+
+	// Set in DefaultGame.ini under [/Script/CoopAdventure.ServerInstanceMonitorSubsystem]
+	UPROPERTY(Config)
+	int32 MemoryBudgetMB;
+
+	// Frame time above this counts as over budget
+	UPROPERTY(Config)
+	float FrameTimeBudgetMs;
+
+	UPROPERTY(Config)
+	float ReportIntervalSeconds;
+
+	// Minimum time between garbage collections forced by the memory budget
+	UPROPERTY(Config)
+	float GarbageCollectionCooldownSeconds;
+
+private:
+	bool Tick(float DeltaTime);
+	void WriteReport();
+
+	FTSTicker::FDelegateHandle TickerHandle;
+
+	FString InstanceId;
+	FString ReportPath;
+
+	double IntervalStartTime;
+	int32 NumFrames;
+	double TotalFrameTime;
+	double MaxFrameTime;
+	int32 NumFramesOverBudget;
+
+	// Last forced collection, and whether the next report should check it brought memory back under budget
+	double LastGarbageCollectionTime;
+	double UsedMBBeforeGarbageCollection;
+	bool bCheckGarbageCollection;
+	int32 NumIneffectiveGarbageCollections;
+};
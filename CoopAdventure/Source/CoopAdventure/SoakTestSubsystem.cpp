@@ -0,0 +1,144 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SoakTestSubsystem.h"
+#include "CoopCharacterMovementComponent.h"
+#include "MultiplayerSessionsSubsystem.h"
+#include "PressurePlate.h"
+#include "PressurePlateSubsystem.h"
+#include "PuzzleRoomVolume.h"
+#include "SoakReport.h"
+#include "EngineUtils.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PlayerController.h"
+
+USoakTestSubsystem::USoakTestSubsystem()
+{
+	PlateDwellSeconds = 3.0f;
+
+	NumPlateActivations = 0;
+	LastConnectionSampleTime = 0.0;
+	DwellTimeLeft = 0.0f;
+}
+
+void USoakTestSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	FParse::Value(FCommandLine::Get(), TEXT("SoakCreateServer="), CreateServerName);
+	FParse::Value(FCommandLine::Get(), TEXT("SoakFindServer="), FindServerName);
+
+	Super::Initialize(Collection);
+}
+
+void USoakTestSubsystem::RequestSession(UWorld* World)
+{
+	UMultiplayerSessionsSubsystem* Sessions = GetGameInstance()->GetSubsystem<UMultiplayerSessionsSubsystem>();
+	if (!Sessions)
+	{
+		return;
+	}
+
+	if (!CreateServerName.IsEmpty())
+	{
+		Sessions->CreateServer(CreateServerName);
+	}
+	else if (!FindServerName.IsEmpty())
+	{
+		Sessions->FindServer(FindServerName);
+	}
+}
+
+void USoakTestSubsystem::OnHostWorldChanged(UWorld* World)
+{
+	// Seamless and hard travel both bring new plates, rebind to the ones in this world
+	for (TActorIterator<APressurePlate> It(World); It; ++It)
+	{
+		It->OnActivationChanged.AddUniqueDynamic(this, &USoakTestSubsystem::OnPlateActivationChanged);
+	}
+}
+
+void USoakTestSubsystem::TickHost(UWorld* World, float DeltaTime)
+{
+	const UNetDriver* NetDriver = World->GetNetDriver();
+	UPuzzleRoomSubsystem* RoomSubsystem = World->GetSubsystem<UPuzzleRoomSubsystem>();
+	if (!NetDriver || !RoomSubsystem || FPlatformTime::Seconds() - LastConnectionSampleTime < 1.0)
+	{
+		return;
+	}
+
+	LastConnectionSampleTime = FPlatformTime::Seconds();
+
+	// Plate state only replicates to the room a player is in, so a connection's bandwidth should follow its room
+	for (const UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		const AActor* Viewer = Connection ? (Connection->ViewTarget ? Connection->ViewTarget.Get() : Connection->PlayerController.Get()) : nullptr;
+		if (Viewer)
+		{
+			ConnectionOutBytesByRoom.FindOrAdd(RoomSubsystem->FindViewerRoom(Viewer)).Add(Connection->OutBytesPerSecond);
+		}
+	}
+}
+
+FVector USoakTestSubsystem::GetBotMoveDirection(UWorld* World, ACharacter* Character, float DeltaTime)
+{
+	if (!TargetPlate.IsValid())
+	{
+		TArray<APressurePlate*> Plates;
+		for (TActorIterator<APressurePlate> It(World); It; ++It)
+		{
+			Plates.Add(*It);
+		}
+		if (Plates.Num() > 0)
+		{
+			TargetPlate = Plates[FMath::RandRange(0, Plates.Num() - 1)];
+			DwellTimeLeft = PlateDwellSeconds;
+		}
+	}
+
+	if (!TargetPlate.IsValid())
+	{
+		return Super::GetBotMoveDirection(World, Character, DeltaTime);
+	}
+
+	const FVector ToPlate = TargetPlate->GetActorLocation() - Character->GetActorLocation();
+	if (ToPlate.Size2D() > 60.0f)
+	{
+		return ToPlate.GetSafeNormal2D();
+	}
+
+	DwellTimeLeft -= DeltaTime;
+	if (DwellTimeLeft <= 0.0f)
+	{
+		TargetPlate.Reset();
+	}
+	return FVector::ZeroVector;
+}
+
+void USoakTestSubsystem::OnPlateActivationChanged(bool bActivated)
+{
+	if (bActivated)
+	{
+		++NumPlateActivations;
+	}
+}
+
+void USoakTestSubsystem::AddReportFields(UWorld* World, TArray<FString>& OutFields) const
+{
+	const UCoopMovementStatsSubsystem* MovementStats = World ? World->GetSubsystem<UCoopMovementStatsSubsystem>() : nullptr;
+
+	OutFields.Add(FString::Printf(TEXT("\"session\": \"%s\""), *CreateServerName));
+	OutFields.Add(FString::Printf(TEXT("\"movementCorrections\": %d"), MovementStats ? MovementStats->GetNumServerCorrections() : 0));
+	OutFields.Add(FString::Printf(TEXT("\"plateActivations\": %d"), NumPlateActivations));
+
+	// Players outside every room are reported under "None"
+	const UPressurePlateSubsystem* PlateSubsystem = World ? World->GetSubsystem<UPressurePlateSubsystem>() : nullptr;
+	TArray<FString> Rooms;
+	for (const TPair<FName, TArray<uint32>>& Room : ConnectionOutBytesByRoom)
+	{
+		Rooms.Add(FString::Printf(TEXT("\"%s\": { \"plateStates\": %d, \"samples\": %d, \"outBytesPerSecondAvg\": %.0f }"),
+			*Room.Key.ToString(), PlateSubsystem ? PlateSubsystem->GetNumPlateStates(Room.Key) : 0,
+			Room.Value.Num(), SoakReport::Average(Room.Value)));
+	}
+	OutFields.Add(FString::Printf(TEXT("\"connectionBytesByRoom\": { %s }"), *FString::Join(Rooms, TEXT(", "))));
+}
@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SoakTestSubsystemBase.h"
+#include "SoakTestSubsystem.generated.h"
+
+class APressurePlate;
+
+/**
+ * CoopAdventure soak test, see USoakTestSubsystemBase. A host started with -SoakCreateServer=<name>
+ * creates a session through UMultiplayerSessionsSubsystem and also reports movement corrections, plate
+ * activations and each connection's outgoing bandwidth grouped by the puzzle room its player stands in,
+ * next to the plate entries replicated for that room. Bots started with -SoakFindServer=<name> join
+ * through FindServer and walk between pressure plates. The report is Saved/Profiling/Soak_<name>.json.
+ * See coop_soak_test.sh.
+ */
+UCLASS(Config=Game)
+class COOPADVENTURE_API USoakTestSubsystem : public USoakTestSubsystemBase
+{
+	GENERATED_BODY()
+
+public:
+	USoakTestSubsystem();
+
+	void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	// How long a bot stands on a plate before walking to the next one
+	UPROPERTY(Config)
+	float PlateDwellSeconds;
+
+protected:
+	virtual bool IsHost() const override { return !CreateServerName.IsEmpty(); }
+	virtual void RequestSession(UWorld* World) override;
+	virtual void OnHostWorldChanged(UWorld* World) override;
+	virtual void TickHost(UWorld* World, float DeltaTime) override;
+	virtual FVector GetBotMoveDirection(UWorld* World, ACharacter* Character, float DeltaTime) override;
+	virtual void AddReportFields(UWorld* World, TArray<FString>& OutFields) const override;
+	virtual FString GetReportFileName() const override { return FString::Printf(TEXT("Soak_%s.json"), *CreateServerName); }
+
+private:
+	UFUNCTION()
+	void OnPlateActivationChanged(bool bActivated);
+
+	FString CreateServerName;
+	FString FindServerName;
+
+	int32 NumPlateActivations;
+
+	// Per-connection OutBytesPerSecond samples, keyed by the viewer's room
+	TMap<FName, TArray<uint32>> ConnectionOutBytesByRoom;
+	double LastConnectionSampleTime;
+
+	// Bot state
+	TWeakObjectPtr<APressurePlate> TargetPlate;
+	float DwellTimeLeft;
+};
@@ -0,0 +1,20 @@
+#!/bin/sh
+# Launches several headless CoopAdventure dedicated server instances on one Linux host.
+# Instances share the same cooked content on disk (and so the OS page cache), each gets its
+# own port, session name and memory budget report in Saved/Profiling/ServerInstance_<id>.csv.
+#
+# Usage: ./coop_server_instances.sh <path to CoopAdventureServer binary> [instances] [first port] [tick rate]
+
+SERVER_BIN=$1
+INSTANCES=${2:-8}
+FIRST_PORT=${3:-7777}
+TICK_RATE=${4:-30}
+
+for i in $(seq 0 $((INSTANCES - 1))); do
+	PORT=$((FIRST_PORT + i))
+	"$SERVER_BIN" -log -Port=$PORT -InstanceId=$i -ServerName="CoopAdventure $i" \
+		-ini:Engine:[/Script/OnlineSubsystemUtils.IpNetDriver]:NetServerMaxTickRate=$TICK_RATE \
+		> "server_$i.log" 2>&1 &
+done
+
+wait
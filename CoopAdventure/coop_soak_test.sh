@@ -0,0 +1,39 @@
+#!/bin/sh
+# Local soak test: one headless host and N headless bots on loopback with emulated latency, jitter and loss.
+# The host creates a session through CreateServer, bots join it through FindServer and walk between
+# pressure plates. The host writes frame time, bandwidth, corrections and plate activations to
+# Saved/Profiling/Soak_Soak.json when the run ends. Pass 0 for the replication graph to run the host on the
+# legacy relevancy loop instead; compare frame time and bandwidth against a run with the graph, which also
+# reports its ServerReplicateActors time.
+#
+# Usage: ./coop_soak_test.sh <path to UnrealEditor binary> [bots] [seconds] [lag ms] [jitter ms] [loss %] [replication graph 1|0]
+
+EDITOR_BIN=$1
+BOTS=${2:-4}
+DURATION=${3:-300}
+LAG=${4:-50}
+JITTER=${5:-10}
+LOSS=${6:-1}
+REPGRAPH=${7:-1}
+
+PROJECT="$(cd "$(dirname "$0")" && pwd)/CoopAdventure.uproject"
+HEADLESS="-game -nullrhi -nosound -unattended -log -NOSTEAM -SoakTest -SoakDuration=$DURATION"
+NET_EMULATION="-PktLag=$LAG -PktLagVariance=$JITTER -PktLoss=$LOSS"
+
+HOST_OPTIONS=""
+if [ "$REPGRAPH" = "0" ]; then
+	HOST_OPTIONS="-ini:Engine:[/Script/OnlineSubsystemUtils.IpNetDriver]:ReplicationDriverClassName="
+fi
+
+"$EDITOR_BIN" "$PROJECT" $HEADLESS $NET_EMULATION $HOST_OPTIONS -SoakCreateServer=Soak > soak_host.log 2>&1 &
+HOST_PID=$!
+
+# Give the host time to create the session and travel before the first search
+sleep 15
+
+for i in $(seq 1 $BOTS); do
+	"$EDITOR_BIN" "$PROJECT" $HEADLESS $NET_EMULATION -SoakFindServer=Soak > "soak_bot_$i.log" 2>&1 &
+done
+
+wait $HOST_PID
+wait
@@ -0,0 +1,212 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CharacterBenchmarkSubsystem.h"
+#include "CoreGlobals.h"
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerStart.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/App.h"
+
+// Frames after each spawn or destroy that aren't sampled, while streaming and anim setup settle
+static constexpr int32 CharacterBenchmarkWarmupFrames = 30;
+
+static FAutoConsoleCommandWithWorldAndArgs CharacterBenchmarkCommand(
+	TEXT("MultiplayerShared.CharacterBenchmark"),
+	TEXT("Spawns characters with <Project>.Server.StripClientComponents at 0 and then 1 and logs game thread ms and memory per character.\n")
+	TEXT("Takes the character count and the frames sampled per step, defaults to 100 300. Run on a dedicated server (-server)."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		UCharacterBenchmarkSubsystem* Benchmark = World ? World->GetSubsystem<UCharacterBenchmarkSubsystem>() : nullptr;
+		if (!Benchmark)
+		{
+			return;
+		}
+
+		const int32 NumCharacters = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100;
+		const int32 NumFrames = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 300;
+		Benchmark->Start(NumCharacters, NumFrames);
+	}));
+
+bool UCharacterBenchmarkSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UCharacterBenchmarkSubsystem::Deinitialize()
+{
+	if (Phase != EPhase::Idle)
+	{
+		Finish();
+	}
+
+	Super::Deinitialize();
+}
+
+bool UCharacterBenchmarkSubsystem::IsTickable() const
+{
+	return Phase != EPhase::Idle;
+}
+
+TStatId UCharacterBenchmarkSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCharacterBenchmarkSubsystem, STATGROUP_Tickables);
+}
+
+void UCharacterBenchmarkSubsystem::Start(int32 InNumCharacters, int32 InNumFrames)
+{
+	if (Phase != EPhase::Idle)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Character benchmark is already running"));
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	if (!World->GetAuthGameMode() || !World->GetAuthGameMode()->DefaultPawnClass)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Character benchmark needs the server's game mode and a default pawn class"));
+		return;
+	}
+
+	const FString StripVariableName = FString::Printf(TEXT("%s.Server.StripClientComponents"), FApp::GetProjectName());
+	StripVariable = IConsoleManager::Get().FindConsoleVariable(*StripVariableName);
+	if (!StripVariable)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Character benchmark: %s doesn't exist"), *StripVariableName);
+		return;
+	}
+
+	if (World->GetNetMode() != NM_DedicatedServer)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Character benchmark: not a dedicated server, characters are never stripped here so both settings cost the same"));
+	}
+
+	PreviousStripValue = StripVariable->GetInt();
+	NumCharacters = InNumCharacters;
+	NumFrames = InNumFrames;
+	StripValue = 0;
+	BeginMode();
+}
+
+void UCharacterBenchmarkSubsystem::BeginMode()
+{
+	// The setting is read when a character registers its components, so it has to be set before spawning
+	StripVariable->Set(StripValue, ECVF_SetByConsole);
+
+	Phase = EPhase::Baseline;
+	FrameIndex = 0;
+	GameThreadMsSum = 0.0;
+}
+
+void UCharacterBenchmarkSubsystem::Tick(float DeltaTime)
+{
+	++FrameIndex;
+	if (FrameIndex <= CharacterBenchmarkWarmupFrames)
+	{
+		return;
+	}
+
+	// Game thread time excludes the wait for the server's tick rate, which would hide the cost otherwise
+	GameThreadMsSum += FPlatformTime::ToMilliseconds(GGameThreadTime);
+	if (FrameIndex < CharacterBenchmarkWarmupFrames + NumFrames)
+	{
+		return;
+	}
+
+	const double AverageGameThreadMs = GameThreadMsSum / NumFrames;
+	FrameIndex = 0;
+	GameThreadMsSum = 0.0;
+
+	if (Phase == EPhase::Baseline)
+	{
+		BaselineGameThreadMs = AverageGameThreadMs;
+		SpawnCharacters();
+		Phase = EPhase::Measure;
+		return;
+	}
+
+	if (Characters.Num() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Character benchmark: no characters could be spawned"));
+		Finish();
+		return;
+	}
+
+	const double TickMsPerCharacter = (AverageGameThreadMs - BaselineGameThreadMs) / Characters.Num();
+	const double BytesPerCharacter = ((double)UsedPhysicalAfterSpawn - (double)UsedPhysicalBeforeSpawn) / Characters.Num();
+	UE_LOG(LogTemp, Log, TEXT("Character benchmark, %d characters, StripClientComponents=%d: game thread %.2f ms (%.2f ms without them), %.4f ms and %.1f KB per character"),
+		Characters.Num(), StripValue, AverageGameThreadMs, BaselineGameThreadMs, TickMsPerCharacter, BytesPerCharacter / 1024.0);
+
+	DestroyCharacters();
+
+	if (StripValue == 0)
+	{
+		StripValue = 1;
+		BeginMode();
+		return;
+	}
+
+	Finish();
+}
+
+void UCharacterBenchmarkSubsystem::SpawnCharacters()
+{
+	UWorld* World = GetWorld();
+	const TSubclassOf<APawn> PawnClass = World->GetAuthGameMode()->DefaultPawnClass;
+
+	FVector Origin = FVector::ZeroVector;
+	TActorIterator<APlayerStart> PlayerStart(World);
+	if (PlayerStart)
+	{
+		Origin = PlayerStart->GetActorLocation();
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParameters.ObjectFlags |= RF_Transient;
+
+	// A square grid around the player start, far enough apart that capsules don't push each other
+	const int32 Columns = FMath::CeilToInt(FMath::Sqrt((float)NumCharacters));
+	UsedPhysicalBeforeSpawn = FPlatformMemory::GetStats().UsedPhysical;
+	for (int32 Index = 0; Index < NumCharacters; ++Index)
+	{
+		const FVector Offset((Index % Columns - Columns / 2) * 200.0f, (Index / Columns - Columns / 2) * 200.0f, 0.0f);
+		if (APawn* Character = World->SpawnActor<APawn>(PawnClass, Origin + Offset, FRotator::ZeroRotator, SpawnParameters))
+		{
+			Character->SpawnDefaultController();
+			Characters.Add(Character);
+		}
+	}
+	UsedPhysicalAfterSpawn = FPlatformMemory::GetStats().UsedPhysical;
+}
+
+void UCharacterBenchmarkSubsystem::DestroyCharacters()
+{
+	for (APawn* Character : Characters)
+	{
+		if (!Character)
+		{
+			continue;
+		}
+
+		if (AController* Controller = Character->GetController())
+		{
+			Controller->Destroy();
+		}
+		Character->Destroy();
+	}
+	Characters.Reset();
+}
+
+void UCharacterBenchmarkSubsystem::Finish()
+{
+	DestroyCharacters();
+	StripVariable->Set(PreviousStripValue, ECVF_SetByConsole);
+	Phase = EPhase::Idle;
+}
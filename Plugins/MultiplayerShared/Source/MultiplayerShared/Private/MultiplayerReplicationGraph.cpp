@@ -0,0 +1,272 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MultiplayerReplicationGraph.h"
+#include "MultiplayerShared.h"
+#include "Engine/LevelScriptActor.h"
+#include "GameFramework/Info.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+
+DECLARE_CYCLE_STAT(TEXT("RepGraph Replicate Actors"), STAT_RepGraphReplicateActors, STATGROUP_MultiplayerShared);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("RepGraph Owner Relevant Actors"), STAT_RepGraphOwnerRelevantActors, STATGROUP_MultiplayerShared);
+
+void UMultiplayerReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	ClassRepNodePolicies.Set(AActor::StaticClass(), EMultiplayerClassRepNodeMapping::Spatialize_Dynamic);
+	ClassRepNodePolicies.Set(ALevelScriptActor::StaticClass(), EMultiplayerClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(AInfo::StaticClass(), EMultiplayerClassRepNodeMapping::RelevantAllConnections);
+
+	InitClassRepNodePolicies();
+
+	TArray<UClass*> ReplicatedClasses;
+	ReplicatedClasses.Add(AActor::StaticClass());
+	ReplicatedClasses.Append(ExplicitlyMappedClasses);
+
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		UClass* Class = *It;
+		const AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject());
+		if (!ActorCDO || !ActorCDO->GetIsReplicated())
+		{
+			continue;
+		}
+
+		// Blueprint compilation leftovers
+		if (Class->GetName().StartsWith(TEXT("SKEL_")) || Class->GetName().StartsWith(TEXT("REINST_")))
+		{
+			continue;
+		}
+
+		ReplicatedClasses.AddUnique(Class);
+
+		if (ClassRepNodePolicies.Contains(Class, false))
+		{
+			continue;
+		}
+
+		ClassRepNodePolicies.Set(Class, GetMappingPolicyForActor(ActorCDO));
+	}
+
+	for (UClass* Class : ReplicatedClasses)
+	{
+		const EMultiplayerClassRepNodeMapping Mapping = GetMappingPolicy(Class);
+		const bool bSpatialize = Mapping != EMultiplayerClassRepNodeMapping::NotRouted && Mapping != EMultiplayerClassRepNodeMapping::RelevantAllConnections;
+
+		FClassReplicationInfo ClassInfo;
+		InitClassReplicationInfo(ClassInfo, Class, bSpatialize);
+		GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+	}
+}
+
+void UMultiplayerReplicationGraph::InitGlobalGraphNodes()
+{
+	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode->CellSize = GridCellSize;
+	GridNode->SpatialBias = FVector2D(SpatialBiasX, SpatialBiasY);
+	if (bDisableSpatialRebuilding)
+	{
+		GridNode->AddToClassRebuildDenyList(AActor::StaticClass());
+	}
+	AddGlobalGraphNode(GridNode);
+
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+}
+
+void UMultiplayerReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	AddConnectionGraphNode(CreateNewNode<UMultiplayerReplicationGraphNode_AlwaysRelevant_ForConnection>(), RepGraphConnection);
+}
+
+void UMultiplayerReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	ApplyRelevancyPolicy(ActorInfo.GetActor(), GlobalInfo);
+
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case EMultiplayerClassRepNodeMapping::NotRouted:
+		break;
+	case EMultiplayerClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+		break;
+	case EMultiplayerClassRepNodeMapping::OwnerRelevant:
+		// Dependents are replicated to every connection their owner is gathered for; without an owner yet,
+		// fall back to the grid. The owner is read once here, a later SetOwner doesn't re-route the actor
+		if (AActor* Owner = ActorInfo.GetActor()->GetOwner())
+		{
+			GlobalActorReplicationInfoMap.AddDependentActor(Owner, ActorInfo.GetActor());
+			DependentActorOwners.Add(ActorInfo.GetActor(), Owner);
+			INC_DWORD_STAT(STAT_RepGraphOwnerRelevantActors);
+		}
+		else
+		{
+			GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+		}
+		break;
+	case EMultiplayerClassRepNodeMapping::Spatialize_Static:
+		GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+		break;
+	case EMultiplayerClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+		break;
+	case EMultiplayerClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+		break;
+	case EMultiplayerClassRepNodeMapping::Custom:
+		RouteAddCustomActor(ActorInfo, GlobalInfo);
+		break;
+	}
+}
+
+void UMultiplayerReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case EMultiplayerClassRepNodeMapping::NotRouted:
+		break;
+	case EMultiplayerClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+		break;
+	case EMultiplayerClassRepNodeMapping::OwnerRelevant:
+	{
+		TWeakObjectPtr<AActor> Owner;
+		if (DependentActorOwners.RemoveAndCopyValue(ActorInfo.GetActor(), Owner))
+		{
+			if (Owner.IsValid())
+			{
+				GlobalActorReplicationInfoMap.RemoveDependentActor(Owner.Get(), ActorInfo.GetActor());
+			}
+			DEC_DWORD_STAT(STAT_RepGraphOwnerRelevantActors);
+		}
+		else
+		{
+			GridNode->RemoveActor_Dynamic(ActorInfo);
+		}
+		break;
+	}
+	case EMultiplayerClassRepNodeMapping::Spatialize_Static:
+		GridNode->RemoveActor_Static(ActorInfo);
+		break;
+	case EMultiplayerClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->RemoveActor_Dynamic(ActorInfo);
+		break;
+	case EMultiplayerClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->RemoveActor_Dormancy(ActorInfo);
+		break;
+	case EMultiplayerClassRepNodeMapping::Custom:
+		RouteRemoveCustomActor(ActorInfo);
+		break;
+	}
+}
+
+int32 UMultiplayerReplicationGraph::ServerReplicateActors(float DeltaSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RepGraphReplicateActors);
+
+	const double StartTime = FPlatformTime::Seconds();
+	const int32 NumReplicated = Super::ServerReplicateActors(DeltaSeconds);
+	ReplicateActorsSeconds += FPlatformTime::Seconds() - StartTime;
+	++NumReplicateActorsFrames;
+
+	return NumReplicated;
+}
+
+double UMultiplayerReplicationGraph::ConsumeAverageReplicateActorsMs()
+{
+	const double AverageMs = NumReplicateActorsFrames > 0 ? ReplicateActorsSeconds * 1000.0 / NumReplicateActorsFrames : 0.0;
+	ReplicateActorsSeconds = 0.0;
+	NumReplicateActorsFrames = 0;
+	return AverageMs;
+}
+
+void UMultiplayerReplicationGraph::SetClassRepNodePolicy(UClass* Class, EMultiplayerClassRepNodeMapping Mapping)
+{
+	ClassRepNodePolicies.Set(Class, Mapping);
+	ExplicitlyMappedClasses.AddUnique(Class);
+}
+
+EMultiplayerClassRepNodeMapping UMultiplayerReplicationGraph::GetMappingPolicy(UClass* Class)
+{
+	const EMultiplayerClassRepNodeMapping* Policy = ClassRepNodePolicies.Get(Class);
+	return Policy ? *Policy : EMultiplayerClassRepNodeMapping::Spatialize_Dynamic;
+}
+
+EMultiplayerClassRepNodeMapping UMultiplayerReplicationGraph::GetMappingPolicyForActor(const AActor* Actor)
+{
+	if (Actor->bOnlyRelevantToOwner)
+	{
+		return EMultiplayerClassRepNodeMapping::NotRouted;
+	}
+
+	if (Actor->bAlwaysRelevant)
+	{
+		return EMultiplayerClassRepNodeMapping::RelevantAllConnections;
+	}
+
+	if (Actor->bNetUseOwnerRelevancy)
+	{
+		return EMultiplayerClassRepNodeMapping::OwnerRelevant;
+	}
+
+	if (Actor->IsA<APawn>() || Actor->IsReplicatingMovement())
+	{
+		return EMultiplayerClassRepNodeMapping::Spatialize_Dynamic;
+	}
+
+	return Actor->NetDormancy > DORM_Awake ? EMultiplayerClassRepNodeMapping::Spatialize_Dormancy : EMultiplayerClassRepNodeMapping::Spatialize_Static;
+}
+
+void UMultiplayerReplicationGraph::SetActorUpdateFrequency(AActor* Actor, float NetUpdateFrequency)
+{
+	FGlobalActorReplicationInfo* GlobalInfo = GlobalActorReplicationInfoMap.Find(Actor);
+	if (!GlobalInfo)
+	{
+		return;
+	}
+
+	const uint16 ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(NetUpdateFrequency);
+	GlobalInfo->Settings.ReplicationPeriodFrame = ReplicationPeriodFrame;
+
+	// Each connection copied the period when it first saw the actor, so update those copies as well
+	for (TArray<TObjectPtr<UNetReplicationGraphConnection>>* ConnectionList : { &Connections, &PendingConnections })
+	{
+		for (UNetReplicationGraphConnection* ConnectionManager : *ConnectionList)
+		{
+			if (FConnectionReplicationActorInfo* ConnectionActorInfo = ConnectionManager ? ConnectionManager->ActorInfoMap.Find(Actor) : nullptr)
+			{
+				ConnectionActorInfo->ReplicationPeriodFrame = ReplicationPeriodFrame;
+			}
+		}
+	}
+}
+
+void UMultiplayerReplicationGraph::ApplyRelevancySettings(FGlobalActorReplicationInfo& GlobalInfo, float NetCullDistance, float NetUpdateFrequency) const
+{
+	if (NetCullDistance > 0.0f)
+	{
+		GlobalInfo.Settings.SetCullDistanceSquared(FMath::Square(NetCullDistance));
+	}
+
+	if (NetUpdateFrequency > 0.0f)
+	{
+		GlobalInfo.Settings.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(NetUpdateFrequency);
+	}
+}
+
+void UMultiplayerReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	ReplicationActorList.Reset();
+
+	for (const FNetViewer& Viewer : Params.Viewers)
+	{
+		ReplicationActorList.ConditionalAdd(Viewer.InViewer);
+		ReplicationActorList.ConditionalAdd(Viewer.ViewTarget);
+	}
+
+	Params.OutGatheredReplicationLists.AddReplicationActorList(ReplicationActorList);
+}
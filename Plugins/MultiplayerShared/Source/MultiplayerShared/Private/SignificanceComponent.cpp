@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SignificanceComponent.h"
+#include "SignificanceSubsystem.h"
+#include "NetUpdateFrequencyDriver.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/NetDriver.h"
+
+USignificanceComponent::USignificanceComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	HighDistance = 2000.0f;
+	MediumDistance = 5000.0f;
+	LowDistance = 10000.0f;
+
+	TierSettings.SetNum(4);
+	TierSettings[(int32)ESignificanceTier::Medium].TickInterval = 0.05f;
+	TierSettings[(int32)ESignificanceTier::Low].TickInterval = 0.2f;
+	TierSettings[(int32)ESignificanceTier::Low].bPlayEffects = false;
+	TierSettings[(int32)ESignificanceTier::Culled].TickInterval = 1.0f;
+	TierSettings[(int32)ESignificanceTier::Culled].bPlayEffects = false;
+
+	Tier = ESignificanceTier::High;
+}
+
+void USignificanceComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	BaseTickInterval = GetOwner()->GetActorTickInterval();
+
+	if (USignificanceSubsystem* Significance = GetWorld()->GetSubsystem<USignificanceSubsystem>())
+	{
+		Significance->RegisterSignificance(this);
+	}
+}
+
+void USignificanceComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (USignificanceSubsystem* Significance = GetWorld()->GetSubsystem<USignificanceSubsystem>())
+	{
+		Significance->UnregisterSignificance(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void USignificanceComponent::SetTier(ESignificanceTier NewTier)
+{
+	if (NewTier == Tier)
+	{
+		return;
+	}
+
+	Tier = NewTier;
+	ApplyTier();
+	OnTierChanged.Broadcast(Tier);
+}
+
+void USignificanceComponent::ApplyTier()
+{
+	if (!TierSettings.IsValidIndex((int32)Tier))
+	{
+		return;
+	}
+
+	const FSignificanceTierSettings& Settings = TierSettings[(int32)Tier];
+	AActor* Owner = GetOwner();
+
+	if (Owner->PrimaryActorTick.bCanEverTick)
+	{
+		Owner->SetActorTickInterval(Settings.TickInterval > 0.0f ? Settings.TickInterval : BaseTickInterval);
+	}
+
+	TInlineComponentArray<USkeletalMeshComponent*> SkeletalMeshes(Owner);
+	for (USkeletalMeshComponent* SkeletalMesh : SkeletalMeshes)
+	{
+		const float* BaseMeshTickInterval = BaseMeshTickIntervals.Find(SkeletalMesh);
+		if (!BaseMeshTickInterval)
+		{
+			BaseMeshTickInterval = &BaseMeshTickIntervals.Add(SkeletalMesh, SkeletalMesh->GetComponentTickInterval());
+		}
+
+		SkeletalMesh->SetComponentTickInterval(Settings.TickInterval > 0.0f ? Settings.TickInterval : *BaseMeshTickInterval);
+	}
+
+	if (!Owner->HasAuthority())
+	{
+		return;
+	}
+
+	// Captured on the first change rather than in BeginPlay so other components have applied their settings
+	if (BaseNetUpdateFrequency < 0.0f)
+	{
+		BaseNetUpdateFrequency = Owner->NetUpdateFrequency;
+	}
+
+	const float NetUpdateFrequency = Settings.NetUpdateFrequency > 0.0f ? Settings.NetUpdateFrequency : BaseNetUpdateFrequency;
+	if (Owner->NetUpdateFrequency != NetUpdateFrequency)
+	{
+		Owner->NetUpdateFrequency = NetUpdateFrequency;
+
+		// A replication graph keeps its own copy of the update rate
+		const UNetDriver* NetDriver = Owner->GetNetDriver();
+		if (INetUpdateFrequencyDriver* ReplicationDriver = NetDriver ? Cast<INetUpdateFrequencyDriver>(NetDriver->GetReplicationDriver()) : nullptr)
+		{
+			ReplicationDriver->SetActorUpdateFrequency(Owner, NetUpdateFrequency);
+		}
+	}
+}
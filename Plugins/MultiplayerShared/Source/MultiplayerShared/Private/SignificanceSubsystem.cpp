@@ -0,0 +1,140 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SignificanceSubsystem.h"
+#include "MultiplayerShared.h"
+#include "SignificanceComponent.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Significance Update"), STAT_SignificanceUpdate, STATGROUP_MultiplayerShared);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Significance Evaluations"), STAT_SignificanceEvaluations, STATGROUP_MultiplayerShared);
+
+static TAutoConsoleVariable<int32> CVarSignificanceEvaluationsPerFrame(
+	TEXT("MultiplayerShared.Significance.EvaluationsPerFrame"),
+	64,
+	TEXT("Number of significance components re-scored each frame."));
+
+bool USignificanceSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && Super::ShouldCreateSubsystem(Outer);
+}
+
+bool USignificanceSubsystem::IsTickable() const
+{
+	return Components.Num() > 0;
+}
+
+TStatId USignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USignificanceSubsystem, STATGROUP_Tickables);
+}
+
+void USignificanceSubsystem::RegisterSignificance(USignificanceComponent* Component)
+{
+	Components.AddUnique(Component);
+}
+
+void USignificanceSubsystem::UnregisterSignificance(USignificanceComponent* Component)
+{
+	Components.RemoveSwap(Component);
+}
+
+void USignificanceSubsystem::GatherViewpoints()
+{
+	Viewpoints.Reset();
+
+	// On a server this visits every player, on a client only the local ones
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (!PlayerController)
+		{
+			continue;
+		}
+
+		if (PlayerController->IsLocalController())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			Viewpoints.Add({ ViewLocation, PlayerController->GetPawn() });
+		}
+		else if (const APawn* Pawn = PlayerController->GetPawn())
+		{
+			Viewpoints.Add({ Pawn->GetActorLocation(), Pawn });
+		}
+	}
+}
+
+void USignificanceSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SignificanceUpdate);
+
+	GatherViewpoints();
+
+	const int32 NumEvaluations = FMath::Min(CVarSignificanceEvaluationsPerFrame.GetValueOnGameThread(), Components.Num());
+	for (int32 Count = 0; Count < NumEvaluations; ++Count)
+	{
+		if (NextIndex >= Components.Num())
+		{
+			NextIndex = 0;
+		}
+
+		if (USignificanceComponent* Component = Components[NextIndex])
+		{
+			Evaluate(Component);
+		}
+		++NextIndex;
+	}
+
+	INC_DWORD_STAT_BY(STAT_SignificanceEvaluations, NumEvaluations);
+}
+
+void USignificanceSubsystem::Evaluate(USignificanceComponent* Component) const
+{
+	const AActor* Owner = Component->GetOwner();
+
+	// Whoever is playing this pawn always gets it at full detail
+	const APawn* Pawn = Cast<APawn>(Owner);
+	if (Pawn && Pawn->IsLocallyControlled())
+	{
+		Component->SetTier(ESignificanceTier::High);
+		return;
+	}
+
+	const FVector Location = Owner->GetActorLocation();
+
+	double MinDistanceSquared = TNumericLimits<double>::Max();
+	for (const FViewpoint& Viewpoint : Viewpoints)
+	{
+		if (Viewpoint.Viewer != Owner)
+		{
+			MinDistanceSquared = FMath::Min(MinDistanceSquared, FVector::DistSquared(Viewpoint.Location, Location));
+		}
+	}
+
+	ESignificanceTier Tier = ESignificanceTier::Culled;
+	if (MinDistanceSquared <= FMath::Square(Component->HighDistance))
+	{
+		Tier = ESignificanceTier::High;
+	}
+	else if (MinDistanceSquared <= FMath::Square(Component->MediumDistance))
+	{
+		Tier = ESignificanceTier::Medium;
+	}
+	else if (MinDistanceSquared <= FMath::Square(Component->LowDistance))
+	{
+		Tier = ESignificanceTier::Low;
+	}
+
+	// Clients also drop actors that are off screen by one tier, a listen server host's screen says nothing about remote players
+	if (Tier < ESignificanceTier::Culled && GetWorld()->GetNetMode() == NM_Client && !Owner->WasRecentlyRendered(0.5f))
+	{
+		Tier = (ESignificanceTier)((uint8)Tier + 1);
+	}
+
+	Component->SetTier(Tier);
+}
@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SoakReport.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+template<typename T>
+static double AverageOf(TConstArrayView<T> Values)
+{
+	double Total = 0.0;
+	for (const T Value : Values)
+	{
+		Total += Value;
+	}
+	return Values.Num() > 0 ? Total / Values.Num() : 0.0;
+}
+
+double SoakReport::Average(TConstArrayView<float> Values)
+{
+	return AverageOf(Values);
+}
+
+double SoakReport::Average(TConstArrayView<uint32> Values)
+{
+	return AverageOf(Values);
+}
+
+float SoakReport::Percentile(TConstArrayView<float> SortedValues, float Fraction)
+{
+	return SortedValues.Num() > 0 ? SortedValues[FMath::Clamp((int32)(Fraction * SortedValues.Num()), 0, SortedValues.Num() - 1)] : 0.0f;
+}
+
+FString SoakReport::FormatFrameTimes(const TArray<float>& FrameTimesMs)
+{
+	TArray<float> Sorted = FrameTimesMs;
+	Sorted.Sort();
+
+	return FString::Printf(TEXT("{ \"avg\": %.2f, \"p50\": %.2f, \"p95\": %.2f, \"p99\": %.2f, \"max\": %.2f }"),
+		Average(Sorted), Percentile(Sorted, 0.5f), Percentile(Sorted, 0.95f), Percentile(Sorted, 0.99f), Percentile(Sorted, 1.0f));
+}
+
+FString SoakReport::FormatBandwidth(const TArray<uint32>& InBytesPerSecond, const TArray<uint32>& OutBytesPerSecond)
+{
+	return FString::Printf(TEXT("{ \"inAvg\": %.0f, \"outAvg\": %.0f, \"outMax\": %u }"),
+		Average(InBytesPerSecond), Average(OutBytesPerSecond), OutBytesPerSecond.Num() > 0 ? FMath::Max(OutBytesPerSecond) : 0u);
+}
+
+void SoakReport::Save(const FString& Report, const FString& FileName)
+{
+	const FString ReportPath = FPaths::ProfilingDir() / FileName;
+	FFileHelper::SaveStringToFile(Report, *ReportPath);
+
+	UE_LOG(LogTemp, Log, TEXT("Soak test report written to %s"), *ReportPath);
+}
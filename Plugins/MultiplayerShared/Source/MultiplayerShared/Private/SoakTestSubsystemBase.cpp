@@ -0,0 +1,202 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SoakTestSubsystemBase.h"
+#include "SoakReport.h"
+#include "MultiplayerReplicationGraph.h"
+#include "Engine/Channel.h"
+#include "Engine/GameInstance.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/App.h"
+
+USoakTestSubsystemBase::USoakTestSubsystemBase()
+{
+	DefaultDurationSeconds = 300.0f;
+	JumpChancePerSecond = 0.1f;
+
+	DurationSeconds = 0.0f;
+	StartTime = 0.0;
+	LastSessionRequestTime = 0.0;
+	LastBandwidthSampleTime = 0.0;
+	MaxConnections = 0;
+	MaxReliableOutstanding = 0;
+	SaturatedSamples = 0;
+	WanderDirection = FVector::ForwardVector;
+}
+
+bool USoakTestSubsystemBase::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return FParse::Param(FCommandLine::Get(), TEXT("SoakTest")) && Super::ShouldCreateSubsystem(Outer);
+}
+
+void USoakTestSubsystemBase::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	DurationSeconds = DefaultDurationSeconds;
+	FParse::Value(FCommandLine::Get(), TEXT("SoakDuration="), DurationSeconds);
+
+	UE_LOG(LogTemp, Log, TEXT("Soak test: %s for %.0f s"), IsHost() ? TEXT("host") : TEXT("bot"), DurationSeconds);
+
+	StartTime = FPlatformTime::Seconds();
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateUObject(this, &USoakTestSubsystemBase::Tick));
+}
+
+void USoakTestSubsystemBase::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+
+	Super::Deinitialize();
+}
+
+bool USoakTestSubsystemBase::Tick(float DeltaTime)
+{
+	UWorld* World = GetGameInstance()->GetWorld();
+	if (!World)
+	{
+		return true;
+	}
+
+	if (FPlatformTime::Seconds() - StartTime >= DurationSeconds)
+	{
+		if (IsHost())
+		{
+			WriteReport();
+		}
+		OnSoakFinished(World);
+
+		FPlatformMisc::RequestExit(false);
+		return false;
+	}
+
+	TickSession(World);
+
+	const ENetMode NetMode = World->GetNetMode();
+	if (NetMode == NM_ListenServer || NetMode == NM_DedicatedServer)
+	{
+		TickHostMetrics(World, DeltaTime);
+		TickHost(World, DeltaTime);
+	}
+	else if (NetMode == NM_Client)
+	{
+		TickBot(World, DeltaTime);
+	}
+
+	return true;
+}
+
+void USoakTestSubsystemBase::TickSession(UWorld* World)
+{
+	// Keep asking until we're hosting or connected; the host may not be up yet when a bot starts
+	if (World->GetNetMode() != NM_Standalone || FPlatformTime::Seconds() - LastSessionRequestTime < 10.0)
+	{
+		return;
+	}
+
+	LastSessionRequestTime = FPlatformTime::Seconds();
+	RequestSession(World);
+}
+
+void USoakTestSubsystemBase::TickHostMetrics(UWorld* World, float DeltaTime)
+{
+	FrameTimesMs.Add(DeltaTime * 1000.0f);
+
+	if (MetricsWorld != World)
+	{
+		MetricsWorld = World;
+		OnHostWorldChanged(World);
+	}
+
+	const UNetDriver* NetDriver = World->GetNetDriver();
+	if (!NetDriver || FPlatformTime::Seconds() - LastBandwidthSampleTime < 1.0)
+	{
+		return;
+	}
+
+	LastBandwidthSampleTime = FPlatformTime::Seconds();
+	InBytesPerSecond.Add(NetDriver->InBytesPerSecond);
+	OutBytesPerSecond.Add(NetDriver->OutBytesPerSecond);
+	MaxConnections = FMath::Max(MaxConnections, NetDriver->ClientConnections.Num());
+
+	// Without a replication driver the legacy relevancy loop runs, which has no timer of its own
+	const UReplicationDriver* ReplicationDriver = NetDriver->GetReplicationDriver();
+	ReplicationDriverName = ReplicationDriver ? ReplicationDriver->GetClass()->GetName() : TEXT("None");
+	if (UMultiplayerReplicationGraph* Graph = Cast<UMultiplayerReplicationGraph>(NetDriver->GetReplicationDriver()))
+	{
+		ReplicateActorsMs.Add(Graph->ConsumeAverageReplicateActorsMs());
+	}
+
+	for (UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		if (!Connection)
+		{
+			continue;
+		}
+
+		if (!Connection->IsNetReady(false))
+		{
+			++SaturatedSamples;
+		}
+
+		for (const UChannel* Channel : Connection->OpenChannels)
+		{
+			if (Channel)
+			{
+				MaxReliableOutstanding = FMath::Max(MaxReliableOutstanding, Channel->NumOutRec);
+			}
+		}
+	}
+}
+
+void USoakTestSubsystemBase::TickBot(UWorld* World, float DeltaTime)
+{
+	APlayerController* PlayerController = GetGameInstance()->GetFirstLocalPlayerController();
+	ACharacter* Character = PlayerController ? Cast<ACharacter>(PlayerController->GetPawn()) : nullptr;
+	if (!Character)
+	{
+		return;
+	}
+
+	Character->AddMovementInput(GetBotMoveDirection(World, Character, DeltaTime));
+
+	if (FMath::FRand() < DeltaTime * JumpChancePerSecond)
+	{
+		Character->Jump();
+	}
+
+	TickBotActions(Character, DeltaTime);
+}
+
+FVector USoakTestSubsystemBase::GetBotMoveDirection(UWorld* World, ACharacter* Character, float DeltaTime)
+{
+	if (FMath::FRand() < DeltaTime * 0.5f)
+	{
+		WanderDirection = FVector(FMath::FRandRange(-1.0f, 1.0f), FMath::FRandRange(-1.0f, 1.0f), 0.0f).GetSafeNormal();
+	}
+	return WanderDirection;
+}
+
+void USoakTestSubsystemBase::WriteReport()
+{
+	TArray<FString> Fields;
+	Fields.Add(FString::Printf(TEXT("\"project\": \"%s\""), FApp::GetProjectName()));
+	Fields.Add(FString::Printf(TEXT("\"durationSeconds\": %.1f"), FPlatformTime::Seconds() - StartTime));
+	Fields.Add(FString::Printf(TEXT("\"frames\": %d"), FrameTimesMs.Num()));
+	Fields.Add(FString::Printf(TEXT("\"frameTimeMs\": %s"), *SoakReport::FormatFrameTimes(FrameTimesMs)));
+	Fields.Add(FString::Printf(TEXT("\"bytesPerSecond\": %s"), *SoakReport::FormatBandwidth(InBytesPerSecond, OutBytesPerSecond)));
+	Fields.Add(FString::Printf(TEXT("\"maxConnections\": %d"), MaxConnections));
+	Fields.Add(FString::Printf(TEXT("\"replicationDriver\": \"%s\""), *ReplicationDriverName));
+	if (ReplicateActorsMs.Num() > 0)
+	{
+		Fields.Add(FString::Printf(TEXT("\"replicateActorsMs\": %s"), *SoakReport::FormatFrameTimes(ReplicateActorsMs)));
+	}
+	Fields.Add(FString::Printf(TEXT("\"reliable\": { \"maxOutstanding\": %d, \"saturatedSamples\": %d }"), MaxReliableOutstanding, SaturatedSamples));
+	AddReportFields(MetricsWorld.Get(), Fields);
+
+	SoakReport::Save(TEXT("{\n\t") + FString::Join(Fields, TEXT(",\n\t")) + TEXT("\n}\n"), GetReportFileName());
+}
@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CharacterBenchmarkSubsystem.generated.h"
+
+class APawn;
+class IConsoleVariable;
+
+/**
+ * Measures what a character costs a server, once with <Project>.Server.StripClientComponents=0 and
+ * once with 1. For each setting it samples game thread time without the characters, spawns N of the
+ * game mode's default pawn with AI controllers, records the memory the spawn took, samples game thread
+ * time again and logs the difference per character. Started with MultiplayerShared.CharacterBenchmark;
+ * only a dedicated server (-server) strips anything, a listen server reports the same cost twice.
+ */
+UCLASS()
+class MULTIPLAYERSHARED_API UCharacterBenchmarkSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	void Start(int32 InNumCharacters, int32 InNumFrames);
+
+private:
+	enum class EPhase : uint8
+	{
+		Idle,
+		Baseline,
+		Measure,
+	};
+
+	void BeginMode();
+	void SpawnCharacters();
+	void DestroyCharacters();
+	void Finish();
+
+	UPROPERTY()
+	TArray<TObjectPtr<APawn>> Characters;
+
+	IConsoleVariable* StripVariable = nullptr;
+	int32 PreviousStripValue = 1;
+
+	EPhase Phase = EPhase::Idle;
+	int32 NumCharacters = 0;
+	int32 NumFrames = 0;
+	int32 StripValue = 0;
+
+	int32 FrameIndex = 0;
+	double GameThreadMsSum = 0.0;
+	double BaselineGameThreadMs = 0.0;
+	uint64 UsedPhysicalBeforeSpawn = 0;
+	uint64 UsedPhysicalAfterSpawn = 0;
+};
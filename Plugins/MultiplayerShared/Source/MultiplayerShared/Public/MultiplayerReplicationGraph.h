@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "NetUpdateFrequencyDriver.h"
+#include "MultiplayerReplicationGraph.generated.h"
+
+class UReplicationGraphNode_GridSpatialization2D;
+class UReplicationGraphNode_ActorList;
+
+// Which global node a replicated class is routed to
+UENUM()
+enum class EMultiplayerClassRepNodeMapping : uint32
+{
+	NotRouted,				// Owner-only actors, handled per connection
+	RelevantAllConnections,	// Game state, player states
+	OwnerRelevant,			// bNetUseOwnerRelevancy actors, replicated along with their owner
+	Spatialize_Static,		// Replicated but never moves
+	Spatialize_Dynamic,		// Moves, e.g. characters
+	Spatialize_Dormancy,	// Mostly dormant
+	Custom,					// Routed by the project's graph through RouteAddCustomActor
+};
+
+/**
+ * Replication graph shared by both projects. Replaces the per-actor, per-connection relevancy loop
+ * with a spatial grid for dynamic and dormant actors plus a global always-relevant list,
+ * so server replication cost grows with what is near each player instead of with actors x connections.
+ * Each project subclasses it to map its own classes and add its own nodes, and enables the subclass
+ * through ReplicationDriverClassName in DefaultEngine.ini.
+ */
+UCLASS(Abstract, Transient, Config = Engine)
+class MULTIPLAYERSHARED_API UMultiplayerReplicationGraph : public UReplicationGraph, public INetUpdateFrequencyDriver
+{
+	GENERATED_BODY()
+
+public:
+	virtual void InitGlobalActorClassSettings() override;
+	virtual void InitGlobalGraphNodes() override;
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual int32 ServerReplicateActors(float DeltaSeconds) override;
+
+	// INetUpdateFrequencyDriver
+	virtual void SetActorUpdateFrequency(AActor* Actor, float NetUpdateFrequency) override;
+
+	// Average ServerReplicateActors time since the last call, for soak reports and benchmarks
+	double ConsumeAverageReplicateActorsMs();
+
+	UPROPERTY(Config)
+	float GridCellSize = 10000.0f;
+
+	// Lowest world coordinate the grid has to cover, the grid grows from here
+	UPROPERTY(Config)
+	float SpatialBiasX = -150000.0f;
+
+	UPROPERTY(Config)
+	float SpatialBiasY = -150000.0f;
+
+	// Dynamic actors are updated in place rather than rebuilding the grid when they leave its bounds
+	UPROPERTY(Config)
+	bool bDisableSpatialRebuilding = true;
+
+	UPROPERTY()
+	TObjectPtr<UReplicationGraphNode_GridSpatialization2D> GridNode;
+
+	UPROPERTY()
+	TObjectPtr<UReplicationGraphNode_ActorList> AlwaysRelevantNode;
+
+protected:
+	// Maps the project's own classes with SetClassRepNodePolicy; classes left out are mapped from their CDO
+	virtual void InitClassRepNodePolicies() {}
+
+	// Also registers Class even if its CDO doesn't replicate, for actors that start replicating after spawning
+	void SetClassRepNodePolicy(UClass* Class, EMultiplayerClassRepNodeMapping Mapping);
+
+	virtual void RouteAddCustomActor(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) {}
+	virtual void RouteRemoveCustomActor(const FNewReplicatedActorInfo& ActorInfo) {}
+
+	// Applies the project's relevancy settings for Actor on top of the class settings
+	virtual void ApplyRelevancyPolicy(const AActor* Actor, FGlobalActorReplicationInfo& GlobalInfo) const {}
+
+	// 0 keeps the class setting
+	void ApplyRelevancySettings(FGlobalActorReplicationInfo& GlobalInfo, float NetCullDistance, float NetUpdateFrequency) const;
+
+private:
+	EMultiplayerClassRepNodeMapping GetMappingPolicy(UClass* Class);
+	EMultiplayerClassRepNodeMapping GetMappingPolicyForActor(const AActor* Actor);
+
+	TClassMap<EMultiplayerClassRepNodeMapping> ClassRepNodePolicies;
+
+	TArray<UClass*> ExplicitlyMappedClasses;
+
+	// Owner each OwnerRelevant actor was made a dependent of, so it can be detached again
+	TMap<AActor*, TWeakObjectPtr<AActor>> DependentActorOwners;
+
+	double ReplicateActorsSeconds = 0.0;
+	int32 NumReplicateActorsFrames = 0;
+};
+
+// Replicates each connection's own player controller and view target
+UCLASS()
+class MULTIPLAYERSHARED_API UMultiplayerReplicationGraphNode_AlwaysRelevant_ForConnection : public UReplicationGraphNode_AlwaysRelevant_ForConnection
+{
+	GENERATED_BODY()
+
+public:
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+};
@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "NetUpdateFrequencyDriver.generated.h"
+
+UINTERFACE(MinimalAPI, meta = (CannotImplementInterfaceInBlueprint))
+class UNetUpdateFrequencyDriver : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Implemented by replication drivers that keep their own copy of each actor's NetUpdateFrequency,
+ * e.g. a replication graph. USignificanceComponent talks to the net driver's replication driver
+ * only through this, so it doesn't depend on a particular project's graph.
+ */
+class MULTIPLAYERSHARED_API INetUpdateFrequencyDriver
+{
+	GENERATED_BODY()
+
+public:
+	// Changes an already routed actor's update rate
+	virtual void SetActorUpdateFrequency(AActor* Actor, float NetUpdateFrequency) = 0;
+};
@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "SignificanceComponent.generated.h"
+
+class USkeletalMeshComponent;
+
+UENUM(BlueprintType)
+enum class ESignificanceTier : uint8
+{
+	High,
+	Medium,
+	Low,
+	Culled,
+};
+
+// What an actor does while it is in one significance tier
+USTRUCT(BlueprintType)
+struct FSignificanceTierSettings
+{
+	GENERATED_BODY()
+
+	// Tick interval for the actor and its skeletal meshes, 0 restores the actor's own interval
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Significance)
+	float TickInterval = 0.0f;
+
+	// 0 restores the actor's own setting
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Significance)
+	float NetUpdateFrequency = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Significance)
+	bool bPlayEffects = true;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FSignificanceTierChangedDelegate, ESignificanceTier);
+
+/**
+ * Puts its owner in a significance tier based on distance to the nearest player and,
+ * on clients, whether it was rendered recently. USignificanceSubsystem re-scores
+ * registered owners a few at a time; each tier change applies the tier's tick interval
+ * and net update frequency, and owners ask ShouldPlayEffects before spawning cosmetics.
+ */
+UCLASS(ClassGroup = (Performance), meta = (BlueprintSpawnableComponent))
+class MULTIPLAYERSHARED_API USignificanceComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	USignificanceComponent();
+
+	ESignificanceTier GetTier() const { return Tier; }
+
+	bool ShouldPlayEffects() const { return TierSettings[(int32)Tier].bPlayEffects; }
+
+	// Called by USignificanceSubsystem
+	void SetTier(ESignificanceTier NewTier);
+
+	FSignificanceTierChangedDelegate OnTierChanged;
+
+	// Farther than this from every player drops the owner out of High
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Significance)
+	float HighDistance;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Significance)
+	float MediumDistance;
+
+	// Farther than this is Culled
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Significance)
+	float LowDistance;
+
+	// Indexed by ESignificanceTier
+	UPROPERTY(EditAnywhere, EditFixedSize, BlueprintReadOnly, Category = Significance)
+	TArray<FSignificanceTierSettings> TierSettings;
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	void ApplyTier();
+
+	ESignificanceTier Tier;
+
+	// The owner's own settings, restored by tiers that leave them at 0
+	float BaseTickInterval = 0.0f;
+	float BaseNetUpdateFrequency = -1.0f;
+
+	// Each skeletal mesh's own tick interval, captured the first time a tier touches it
+	TMap<TWeakObjectPtr<USkeletalMeshComponent>, float> BaseMeshTickIntervals;
+};
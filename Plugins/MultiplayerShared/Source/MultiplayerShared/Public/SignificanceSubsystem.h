@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SignificanceSubsystem.generated.h"
+
+class USignificanceComponent;
+
+/**
+ * Scores every USignificanceComponent against the players' viewpoints and moves it between tiers.
+ * Only a slice of the components is re-scored each frame, so the cost stays flat as actors are added.
+ * Servers use every player's pawn as a viewpoint, clients use their local camera.
+ */
+UCLASS()
+class MULTIPLAYERSHARED_API USignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterSignificance(USignificanceComponent* Component);
+	void UnregisterSignificance(USignificanceComponent* Component);
+
+private:
+	void GatherViewpoints();
+	void Evaluate(USignificanceComponent* Component) const;
+
+	UPROPERTY()
+	TArray<TObjectPtr<USignificanceComponent>> Components;
+
+	// Viewer is the pawn the viewpoint belongs to, a pawn is never scored against itself
+	struct FViewpoint
+	{
+		FVector Location;
+		const AActor* Viewer;
+	};
+
+	TArray<FViewpoint> Viewpoints;
+
+	// Next component to re-score
+	int32 NextIndex = 0;
+};
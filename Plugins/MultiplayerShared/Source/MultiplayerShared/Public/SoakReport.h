@@ -0,0 +1,25 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Summary statistics and JSON fragments shared by the soak test reports
+namespace SoakReport
+{
+	// Mean of the samples, 0 when there are none
+	MULTIPLAYERSHARED_API double Average(TConstArrayView<float> Values);
+	MULTIPLAYERSHARED_API double Average(TConstArrayView<uint32> Values);
+
+	// Sample at Fraction of the way through SortedValues, 0 when there are none
+	MULTIPLAYERSHARED_API float Percentile(TConstArrayView<float> SortedValues, float Fraction);
+
+	// { "avg", "p50", "p95", "p99", "max" } object for a set of frame times
+	MULTIPLAYERSHARED_API FString FormatFrameTimes(const TArray<float>& FrameTimesMs);
+
+	// { "inAvg", "outAvg", "outMax" } object for per-second bandwidth samples
+	MULTIPLAYERSHARED_API FString FormatBandwidth(const TArray<uint32>& InBytesPerSecond, const TArray<uint32>& OutBytesPerSecond);
+
+	// Writes Report to Saved/Profiling/FileName
+	MULTIPLAYERSHARED_API void Save(const FString& Report, const FString& FileName);
+}
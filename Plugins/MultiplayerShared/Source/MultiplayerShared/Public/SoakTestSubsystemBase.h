@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/Ticker.h"
+#include "SoakTestSubsystemBase.generated.h"
+
+class ACharacter;
+
+/**
+ * Soak test scaffolding shared by both projects, only created with -SoakTest on the command line.
+ * Every instance exits after -SoakDuration=<seconds>. Until then an instance that isn't hosting or
+ * connected yet keeps asking for a session, the host records frame time, bandwidth, connections,
+ * reliable buffer pressure and, under UMultiplayerReplicationGraph, ServerReplicateActors time,
+ * and bots wander and jump. Running the host once with the graph and once with the legacy relevancy
+ * loop compares the two under the same bots. Each project subclasses it for how sessions are
+ * found, what bots do on top of wandering and which counters go into Saved/Profiling/<GetReportFileName()>.
+ */
+UCLASS(Abstract, Config=Game)
+class MULTIPLAYERSHARED_API USoakTestSubsystemBase : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	USoakTestSubsystemBase();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	void Initialize(FSubsystemCollectionBase& Collection) override;
+	void Deinitialize() override;
+
+	// Used when -SoakDuration isn't given
+	UPROPERTY(Config)
+	float DefaultDurationSeconds;
+
+	// Chance per second that a bot jumps
+	UPROPERTY(Config)
+	float JumpChancePerSecond;
+
+protected:
+	// Subclasses parse their command line before calling Super::Initialize, so this is ready by then
+	virtual bool IsHost() const PURE_VIRTUAL(USoakTestSubsystemBase::IsHost, return false;);
+
+	// Called every 10 s while the instance is still standalone
+	virtual void RequestSession(UWorld* World) PURE_VIRTUAL(USoakTestSubsystemBase::RequestSession, );
+
+	// Called once the host's world changes, e.g. after travel
+	virtual void OnHostWorldChanged(UWorld* World) {}
+
+	virtual void TickHost(UWorld* World, float DeltaTime) {}
+
+	// Direction the bot walks in this frame, wandering at random by default
+	virtual FVector GetBotMoveDirection(UWorld* World, ACharacter* Character, float DeltaTime);
+
+	virtual void TickBotActions(ACharacter* Character, float DeltaTime) {}
+
+	// Called on every instance right before it exits
+	virtual void OnSoakFinished(UWorld* World) {}
+
+	// Project specific "name": value pairs, appended to the host's report
+	virtual void AddReportFields(UWorld* World, TArray<FString>& OutFields) const {}
+
+	virtual FString GetReportFileName() const PURE_VIRTUAL(USoakTestSubsystemBase::GetReportFileName, return FString(););
+
+	float DurationSeconds;
+	double StartTime;
+
+private:
+	bool Tick(float DeltaTime);
+	void TickSession(UWorld* World);
+	void TickHostMetrics(UWorld* World, float DeltaTime);
+	void TickBot(UWorld* World, float DeltaTime);
+	void WriteReport();
+
+	FTSTicker::FDelegateHandle TickerHandle;
+
+	double LastSessionRequestTime;
+
+	// Host metrics
+	TArray<float> FrameTimesMs;
+	TArray<uint32> InBytesPerSecond;
+	TArray<uint32> OutBytesPerSecond;
+	TArray<float> ReplicateActorsMs;
+	FString ReplicationDriverName;
+	double LastBandwidthSampleTime;
+	int32 MaxConnections;
+	TWeakObjectPtr<UWorld> MetricsWorld;
+
+	// Largest number of unacknowledged reliable bunches on any channel, and how often a connection was saturated
+	int32 MaxReliableOutstanding;
+	int32 SaturatedSamples;
+
+	// Bot state
+	FVector WanderDirection;
+};